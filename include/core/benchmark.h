@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief Time the systems iterating the owning groups of ecs/component/groups.h against plain views
+ *
+ * Two registries are filled with the same entities. Each component is added in its own shuffled order, so the pools
+ * of a view disagree on the order of their entities as they do after a while in a real scene. One registry carries
+ * ViewLayout, so the same system code iterates views there. The time per step of RigidBodySystem::update,
+ * ColliderCacheSystem::update and the traversal of RenderSystem::draw_scene is logged for both layouts.
+ * @param entity_count Entities per registry, most of them carry several of the components
+ * @param passes Steps averaged, after an untimed first one
+ */
+void run_layout_benchmark(size_t entity_count = 100000, int passes = 50);
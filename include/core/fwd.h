@@ -9,6 +9,7 @@
 #define M_MODEL_LOAD_THREAD 1
 #define M_MAX_SHADER_COUNT 64
 #define M_SHADER_LOAD_THREAD 1
+#define M_SDF_CACHE_DIR "cache/sdf"
 
 #include <core/filesystem/resolver.h>
 #include <core/window/window_manager.h>
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of worker threads executing data-parallel loops
+ *
+ * The calling thread takes part in the work. A loop started from inside a worker, or while another loop is
+ * running, is executed inline on the calling thread, so nested parallel_for calls cannot deadlock.
+ */
+class ThreadPool {
+public:
+    /**
+     * @param num_threads Number of background workers, the caller is an additional one
+     */
+    explicit ThreadPool(size_t num_threads) noexcept;
+
+    ~ThreadPool() noexcept;
+
+    ThreadPool(const ThreadPool &other) = delete;
+
+    ThreadPool &operator=(const ThreadPool &other) = delete;
+
+    /**
+     * @brief Number of threads taking part in a loop, including the caller
+     */
+    [[nodiscard]] size_t get_thread_count() const noexcept;
+
+    /**
+     * @brief Number of chunks parallel_for splits a range into
+     *
+     * Depends only on the arguments and the pool size, so per-chunk buffers merged by chunk index give the same
+     * result on every run.
+     */
+    [[nodiscard]] size_t chunk_count(size_t count, size_t min_chunk_size) const noexcept;
+
+    /**
+     * @brief Split [0, count) into contiguous chunks and run them in parallel, blocking until all are done
+     * @param count Size of the range
+     * @param min_chunk_size Smallest number of items worth handing to a thread
+     * @param task Called as task(chunk_index, begin, end) for each chunk
+     */
+    void parallel_for(size_t count, size_t min_chunk_size,
+                      const std::function<void(size_t chunk, size_t begin, size_t end)> &task) noexcept;
+
+private:
+    struct Job {
+        const std::function<void(size_t, size_t, size_t)> *task = nullptr;
+        size_t count      = 0;
+        size_t chunk_size = 0;
+        size_t chunks     = 0;
+        std::atomic<size_t> next_chunk{ 0 };
+        std::atomic<size_t> pending{ 0 };
+    };
+
+    std::vector<std::thread> m_workers;
+    std::shared_ptr<Job> m_job;
+    uint64_t m_generation = 0;
+    std::mutex m_mutex;
+    std::mutex m_job_mutex;
+    std::condition_variable m_cv;
+    std::condition_variable m_done_cv;
+    bool m_stop = false;
+
+    void worker_thread() noexcept;
+
+    void run_chunks(Job &job) noexcept;
+};
+
+std::shared_ptr<ThreadPool> get_thread_pool();
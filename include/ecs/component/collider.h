@@ -1,15 +1,26 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <scene/model/convex_hull.h>
+#include <scene/model/height_field.h>
 #include <scene/model/model.h>
+#include <scene/model/signed_distance_field.h>
+#include <scene/model/triangle_mesh_bvh.h>
+
+class CompoundShape;
 
 struct Collider {
-    enum ShapeType { SPHERE, BOX, CAPSULE } shape;
+    // PLANE is the solid half space below the local x/z plane and HEIGHTFIELD a terrain grid. Like meshes and
+    // distance fields they are static and do not collide with each other. COMPOUND groups child shapes of the
+    // other types into one collider.
+    enum ShapeType { SPHERE, BOX, CAPSULE, CONVEX_HULL, TRIANGLE_MESH, SDF, PLANE, HEIGHTFIELD, COMPOUND } shape;
 
     // Common properties
     glm::vec3 offset{ 0.0f };  // Local offset from entity's transform
     bool is_trigger   = false; // Trigger flag (no physical response)
     bool is_active    = true;  // Collision detection toggle
+    uint32_t layer    = 1u;    // Layer bits this collider belongs to
+    uint32_t mask     = ~0u;   // Layers it interacts with, both colliders of a pair must accept each other
     float friction    = 0.5f;  // Surface friction coefficient (0-1)
     float restitution = 0.2f;  // Bounce coefficient (0=inelastic, 1=perfect bounce)
     union {
@@ -23,6 +34,16 @@ struct Collider {
             float capsule_radius, capsule_height;
         }; // Capsule parameters
     };
+    // Shared shape data in model space, only read for the matching shape type
+    std::shared_ptr<ConvexHull> convex_hull;                    // See ModelManager::get_convex_hull
+    std::shared_ptr<TriangleMeshBVH> triangle_mesh;             // See ModelManager::get_triangle_mesh
+    std::shared_ptr<SignedDistanceField> signed_distance_field; // See ModelManager::get_signed_distance_field
+    std::shared_ptr<HeightField> height_field;                  // See HeightField::from_file
+    std::shared_ptr<CompoundShape> compound;                    // See CompoundShape::build
+    // Increment after changing the shape, its data or the offset of a collider in place, so its world cache is rebuilt.
+    // Colliders added, replaced or patched through the registry are bumped by ColliderCacheSystem. Moving the entity
+    // needs no bump, transforms are tracked on their own.
+    uint32_t version = 0;
     bool visualize = false;
     std::shared_ptr<Model> visualize_model;
 
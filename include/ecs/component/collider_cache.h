@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <ecs/system/physics_subsystem/broadphase/aabb.h>
+#include <glm/glm.hpp>
+
+struct Collider;
+struct Transform;
+
+/**
+ * @brief World-space state of a collider, refreshed once per physics step by ColliderCacheSystem
+ *
+ * The collider frame is the entity transform followed by the collider's local offset, the same frame the collider
+ * is visualized in. Narrowphase and cloth collision read it instead of rebuilding matrices for every query. The
+ * versions it was built from are kept alongside, so colliders that neither moved nor changed are not recomputed.
+ */
+struct ColliderCache {
+    glm::mat4 matrix{ 1.0f };         // Collider frame to world
+    glm::mat4 inverse_matrix{ 1.0f }; // World to collider frame
+    glm::mat3 basis{ 1.0f };          // Unit axes of the collider frame in world space
+    glm::vec3 center{ 0.0f };         // Origin of the collider frame in world space
+    glm::vec3 capsule_base{ 0.0f };   // Capsule segment end points (capsules only)
+    glm::vec3 capsule_top{ 0.0f };
+    AABB aabb;
+    uint32_t transform_version = UINT32_MAX; // Transform::get_world_version of the last refresh
+    uint32_t collider_version  = UINT32_MAX; // Collider::version of the last refresh
+
+    /**
+     * @brief Recompute the world-space data of a collider and record the versions it was built from
+     * @param t Transform of the entity
+     * @param c Collider of the entity
+     */
+    void refresh(const Transform &t, const Collider &c);
+
+    /**
+     * @brief Recompute the world-space data of a collider placed in an arbitrary frame, e.g. a compound child
+     * @param frame Collider frame to world, offset included
+     */
+    void refresh(const glm::mat4 &frame, const Collider &c);
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <ecs/component/collider.h>
+#include <ecs/component/collider_cache.h>
+#include <ecs/system/physics_subsystem/broadphase/aabb.h>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+
+/**
+ * @brief Child shapes of a COMPOUND collider, placed in the collider frame and indexed by a small AABB tree
+ *
+ * Shared between colliders like the other shape data. The broadphase sees a single box around all children, the
+ * narrowphase and cloth collision only descend into the children whose bounds overlap the other shape.
+ */
+class CompoundShape {
+public:
+    struct Child {
+        Collider collider; // Any shape but a compound, its offset is replaced by the child placement
+        glm::vec3 position{ 0.0f };
+        glm::quat rotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+    };
+    struct Node {
+        AABB bounds;     // In the collider frame
+        uint32_t first;  // Left child for inner nodes (the right child follows it), child shape for leaves
+        uint32_t count;  // 1 for leaves, 0 for inner nodes
+    };
+
+    /**
+     * @brief Add a child shape, call build once all children are added
+     */
+    void add_child(const Collider &collider, const glm::vec3 &position,
+                   const glm::quat &rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+
+    /**
+     * @brief Compute the child bounds and rebuild the tree
+     */
+    void build();
+
+    /**
+     * @brief Visit every child whose bounds overlap a box
+     * @param bounds Box in the collider frame
+     * @param callback Called as callback(child_index)
+     */
+    template <typename Callback> void query(const AABB &bounds, Callback &&callback) const {
+        if (m_nodes.empty())
+            return;
+        uint32_t stack[max_depth + 2];
+        int size      = 0;
+        stack[size++] = 0;
+        while (size > 0) {
+            const Node &node = m_nodes[stack[--size]];
+            if (!node.bounds.overlaps(bounds))
+                continue;
+            if (node.count > 0) {
+                callback(node.first);
+            } else {
+                stack[size++] = node.first;
+                stack[size++] = node.first + 1;
+            }
+        }
+    }
+
+    /**
+     * @brief World-space data of a child shape
+     * @param compound World cache of the compound collider
+     */
+    void child_cache(const ColliderCache &compound, uint32_t child, ColliderCache &cache) const;
+
+    [[nodiscard]] const std::vector<Child> &get_children() const noexcept;
+
+    /**
+     * @brief Bounds of all children in the collider frame
+     */
+    [[nodiscard]] AABB get_bounds() const noexcept;
+
+private:
+    constexpr static int max_depth = 32; // Median splits keep the tree balanced, this bounds the query stack
+
+    std::vector<Child> m_children;
+    std::vector<glm::mat4> m_matrices; // Child frame to collider frame
+    std::vector<AABB> m_child_bounds;  // In the collider frame
+    std::vector<Node> m_nodes;         // Root first
+
+    /**
+     * @brief Recursive build of order[begin, end) into m_nodes[node], appending the child pairs it needs
+     */
+    void build_node(std::vector<uint32_t> &order, uint32_t node, uint32_t begin, uint32_t end);
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <ecs/component/collider.h>
+#include <ecs/component/collider_cache.h>
+#include <ecs/component/renderable.h>
+#include <ecs/component/rigidbody.h>
+#include <ecs/component/transform.h>
+#include <entt/entt.hpp>
+
+/**
+ * @brief Owning groups of the component sets iterated every step
+ *
+ * The components a group owns are kept in the same dense order in their pools, with the group's entities packed at
+ * the front, so iterating it walks those pools linearly instead of looking every entity up in the other sparse
+ * sets. A pool can only be owned by one group: Transform belongs to the rigid body group, whose integration loop
+ * reads and writes it, while the collider and render groups reach it through its sparse set. Always go through
+ * these functions, a differently declared group owning one of these components would conflict with them.
+ */
+inline auto body_group(entt::registry &registry) { return registry.group<Transform, RigidBody>(); }
+
+// Colliders with their world cache, which the cache system adds to every collider that has a transform
+inline auto collider_group(entt::registry &registry) {
+    return registry.group<Collider, ColliderCache>(entt::get<Transform>);
+}
+
+inline auto render_group(entt::registry &registry) { return registry.group<Renderable>(entt::get<Transform>); }
+
+/**
+ * @brief Registry context flag that makes the each_* functions below iterate plain views and never create the groups
+ *
+ * Only meant for timing the same system code on both layouts, see run_layout_benchmark.
+ */
+struct ViewLayout {};
+
+/**
+ * @brief Call func for every entity of body_group, or of the matching view under ViewLayout
+ *
+ * Groups and views pass the components in the same order, so func works with either, with or without the entity.
+ */
+template <typename Func> void each_body(entt::registry &registry, Func &&func) {
+    if (registry.ctx().contains<ViewLayout>())
+        registry.view<Transform, RigidBody>().each(std::forward<Func>(func));
+    else
+        body_group(registry).each(std::forward<Func>(func));
+}
+
+/**
+ * @brief Call func for every entity of collider_group, or of the matching view under ViewLayout
+ */
+template <typename Func> void each_collider(entt::registry &registry, Func &&func) {
+    if (registry.ctx().contains<ViewLayout>())
+        registry.view<Collider, ColliderCache, Transform>().each(std::forward<Func>(func));
+    else
+        collider_group(registry).each(std::forward<Func>(func));
+}
+
+/**
+ * @brief Call func for every entity of render_group, or of the matching view under ViewLayout
+ */
+template <typename Func> void each_renderable(entt::registry &registry, Func &&func) {
+    if (registry.ctx().contains<ViewLayout>())
+        registry.view<Renderable, Transform>().each(std::forward<Func>(func));
+    else
+        render_group(registry).each(std::forward<Func>(func));
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <ecs/component/collider.h>
+#include <ecs/component/renderable.h>
+#include <ecs/component/rigidbody.h>
+#include <ecs/component/transform.h>
+#include <entt/entt.hpp>
+#include <optional>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Compact description of an entity spawned many times, e.g. debris
+ *
+ * Components left empty are not added, every instance gets its own copy of the others. Shape and model data are
+ * shared pointers, so copies share them.
+ */
+struct Prefab {
+    /**
+     * @brief Placement and initial motion of one instance
+     */
+    struct Instance {
+        glm::vec3 position{ 0.0f };
+        glm::quat rotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+        glm::vec3 linear_velocity{ 0.0f }; // Ignored without a rigid body
+        glm::vec3 angular_velocity{ 0.0f };
+    };
+
+    glm::vec3 scale{ 1.0f };
+    std::optional<Collider> collider;
+    std::optional<RigidBody> rigidbody;
+    std::optional<Renderable> renderable;
+
+    /**
+     * @brief Create one entity per instance in a single batch
+     *
+     * Every pool is reserved once and filled with one block insert, which keeps the new components contiguous.
+     * Collider caches are added empty and filled by ColliderCacheSystem on the next step, so the colliders enter
+     * the broadphase together.
+     * @return Created entities in instance order
+     */
+    std::vector<entt::entity> instantiate(entt::registry &registry, std::span<const Instance> instances) const;
+};
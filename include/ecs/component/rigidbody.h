@@ -29,10 +29,24 @@ struct RigidBody {
     bool use_gravity      = true;
     bool is_kinematic     = false;
 
+    // Continuous collision: the motion of the step is swept instead of only testing the end pose, so the body
+    // cannot tunnel through thin colliders. Meant for small, fast objects such as projectiles.
+    bool is_fast = false;
+    glm::vec3 previous_position{ 0.0f }; // Position before the last integration step
+
     // Constraints
     glm::bvec3 freeze_position{ false };
     glm::bvec3 freeze_rotation{ false };
 
+    // Sleeping
+    bool can_sleep    = true;
+    bool is_sleeping  = false;
+    float sleep_timer = 0.0f; // Time spent below the sleep velocity thresholds
+
+    constexpr static float sleep_linear_velocity  = 0.05f;
+    constexpr static float sleep_angular_velocity = 0.05f;
+    constexpr static float time_to_sleep          = 0.5f;
+
     void set_mass(float new_mass);
 
     void set_inertia_tensor(const glm::mat3& new_inertia);
@@ -49,7 +63,24 @@ struct RigidBody {
      */
     void integrate(float dt, const glm::vec3 &gravity);
 
-    // Force application methods
+    /**
+     * @brief Advance the sleep timer, resetting it whenever the body moves faster than the thresholds
+     * @param dt Delta time in seconds
+     * @return true if the body has been resting long enough to be put to sleep
+     */
+    bool update_sleep_timer(float dt);
+
+    /**
+     * @brief Stop simulating the body until it is woken up, clearing velocities and accumulated forces
+     */
+    void sleep();
+
+    /**
+     * @brief Resume simulating the body
+     */
+    void wake_up();
+
+    // Force application methods, these wake the body up
     void add_force(const glm::vec3 &force);
 
     void add_force_at_position(const glm::vec3 &force, const glm::vec3 &position);
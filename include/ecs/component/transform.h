@@ -1,19 +1,84 @@
 #pragma once
 
+#include <cmath>
+#include <entt/entt.hpp>
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 
+/**
+ * @brief Position, orientation and scale of an entity, relative to its parent if it has one
+ *
+ * The fields are written directly. The local matrix and its inverse are cached together with the field values they
+ * were built from. The first access after any field changes rebuilds both, so they are computed at most once per
+ * change however often they are read. Rebuilding writes the cache, so a transform whose fields just changed must not
+ * be read from several threads at once.
+ *
+ * World matrices of entities with a parent are written by TransformHierarchy during the step. Without a parent
+ * the world matrix is the local one.
+ */
 struct Transform {
     // Spatial transformation parameters
     glm::vec3 position{ 0.0f };
-    glm::vec3 rotation{ 0.0f }; // Euler angles (in radians)
+    glm::quat rotation{ 1.0f, 0.0f, 0.0f, 0.0f }; // Unit quaternion
     glm::vec3 scale{ 1.0f };
+    // Entity whose world frame this transform is relative to. Children follow their parent and are not moved by
+    // physics, the solver treats a rigid body with a parent as kinematic.
+    entt::entity parent{ entt::null };
 
+    /**
+     * @param rot Euler angles in radians, converted once
+     */
     explicit Transform(const glm::vec3 &pos = glm::vec3(0.0f), const glm::vec3 &rot = glm::vec3(0.0f),
                        const glm::vec3 &scl = glm::vec3(1.0f));
 
-    // Get the orientation quaternion (automatically cached)
-    [[nodiscard]] glm::quat orientation() const;
+    Transform(const glm::vec3 &pos, const glm::quat &rot, const glm::vec3 &scl = glm::vec3(1.0f));
 
-    // Generate the model matrix
-    [[nodiscard]] glm::mat4 matrix() const;
+    [[nodiscard]] const glm::quat &orientation() const;
+
+    /**
+     * @brief Orientation as Euler angles in radians, for editing and display only
+     */
+    [[nodiscard]] glm::vec3 euler_angles() const;
+
+    void set_euler_angles(const glm::vec3 &angles);
+
+    // Local matrix, translation * rotation * scale
+    [[nodiscard]] const glm::mat4 &matrix() const;
+
+    [[nodiscard]] const glm::mat4 &inverse_matrix() const;
+
+    // Local to world, the parent's world matrix times the local one
+    [[nodiscard]] const glm::mat4 &world_matrix() const;
+
+    [[nodiscard]] const glm::mat4 &world_inverse_matrix() const;
+
+    /**
+     * @brief Number of times the local matrices were rebuilt, changes whenever a field changed since the last read
+     */
+    [[nodiscard]] uint32_t get_version() const;
+
+    /**
+     * @brief Changes whenever the world matrix may have changed, through the own fields, the parent link or an
+     * ancestor. Systems deriving data from the world matrix keep the version they built it from and skip the
+     * entity while it matches.
+     */
+    [[nodiscard]] uint32_t get_world_version() const;
+
+private:
+    friend class TransformHierarchy;
+
+    mutable glm::mat4 m_matrix{ 1.0f };
+    mutable glm::mat4 m_inverse_matrix{ 1.0f };
+    // Field values the matrices were built from, NaN until the first build
+    mutable glm::vec3 m_built_position{ NAN };
+    mutable glm::quat m_built_rotation{ NAN, NAN, NAN, NAN };
+    mutable glm::vec3 m_built_scale{ NAN };
+    mutable entt::entity m_built_parent{ entt::null };
+    mutable uint32_t m_version = 0;
+    // World matrices, only read while the transform has a parent
+    glm::mat4 m_world_matrix{ 1.0f };
+    glm::mat4 m_world_inverse_matrix{ 1.0f };
+    uint32_t m_world_changes = 0; // Writes of the world matrices
+
+    void update_matrices() const;
 };
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cfloat>
+#include <glm/glm.hpp>
+
+/**
+ * @brief World-space axis-aligned bounding box
+ */
+struct AABB {
+    glm::vec3 min{ FLT_MAX };
+    glm::vec3 max{ -FLT_MAX };
+
+    [[nodiscard]] bool overlaps(const AABB &other) const {
+        return min.x <= other.max.x && max.x >= other.min.x && min.y <= other.max.y && max.y >= other.min.y &&
+               min.z <= other.max.z && max.z >= other.min.z;
+    }
+
+    [[nodiscard]] bool contains(const AABB &other) const {
+        return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z && max.x >= other.max.x &&
+               max.y >= other.max.y && max.z >= other.max.z;
+    }
+
+    [[nodiscard]] glm::vec3 center() const { return (min + max) * 0.5f; }
+
+    [[nodiscard]] float surface_area() const {
+        const glm::vec3 d = max - min;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    /**
+     * @brief Bounds of this box after an affine transform, e.g. into or out of a collider frame
+     */
+    [[nodiscard]] AABB transformed(const glm::mat4 &matrix) const {
+        const glm::vec3 half   = (max - min) * 0.5f;
+        const glm::vec3 middle = glm::vec3(matrix * glm::vec4(center(), 1.0f));
+        glm::vec3 extent(0.0f);
+        for (int i = 0; i < 3; ++i)
+            extent += glm::abs(glm::vec3(matrix[i])) * half[i];
+        return { middle - extent, middle + extent };
+    }
+
+    static AABB merge(const AABB &a, const AABB &b) { return { glm::min(a.min, b.min), glm::max(a.max, b.max) }; }
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <ecs/system/physics_subsystem/broadphase/dynamic_aabb_tree.h>
+#include <unordered_map>
+
+/**
+ * @brief Broadphase built on two dynamic AABB trees
+ *
+ * Static colliders live in their own tree which is filled once and only touched again if one of them is moved by
+ * hand. Moving bodies live in a second tree and are the only ones issuing queries, against both trees, so the cost
+ * of a step scales with the number of moving bodies rather than the size of the level.
+ */
+class AabbTreeBroadphase : public Broadphase {
+public:
+    void update(const std::vector<BroadphaseProxy> &proxies) override;
+
+    void find_pairs(std::vector<BroadphasePair> &pairs) override;
+
+private:
+    struct Record {
+        BroadphaseProxy proxy{ entt::null }; // Entity is null while the record is on the free list
+        int node       = DynamicAabbTree::null_node;
+        uint32_t stamp = 0;
+        AABB fat; // Copy of the fat box in the tree, tested without touching the tree
+    };
+
+    DynamicAabbTree m_dynamic_tree;
+    DynamicAabbTree m_static_tree;
+    std::vector<Record> m_records;
+    std::vector<int> m_free_records;
+    std::unordered_map<entt::entity, int> m_lookup;
+    uint32_t m_stamp = 0;
+
+    void insert(int record);
+
+    void remove(int record);
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <ecs/system/physics_subsystem/broadphase/aabb.h>
+#include <entt/entt.hpp>
+#include <vector>
+
+/**
+ * @brief Broadphase entry of one active collider for the current step
+ */
+struct BroadphaseProxy {
+    entt::entity entity;
+    AABB aabb;
+    bool is_static; // Not moved by simulation this step (no rigid body, zero mass or sleeping)
+    bool is_trigger;
+    uint32_t layer;
+    uint32_t mask;
+};
+
+/**
+ * @brief Pair filter shared by every broadphase strategy, applied before a pair is reported
+ *
+ * Two static proxies cannot start moving through a contact and two triggers have no one to report to, everything
+ * else must be accepted by the layer mask of both proxies.
+ */
+inline bool can_pair(const BroadphaseProxy &a, const BroadphaseProxy &b) {
+    return (!a.is_static || !b.is_static) && (!a.is_trigger || !b.is_trigger) && (a.layer & b.mask) != 0 &&
+           (b.layer & a.mask) != 0;
+}
+
+/**
+ * @brief Candidate pair whose bounds overlap and which must go through narrowphase
+ */
+struct BroadphasePair {
+    entt::entity a;
+    entt::entity b;
+};
+
+/**
+ * @brief Available broadphase strategies, selectable per scene
+ */
+enum class BroadphaseType { SweepAndPrune, AabbTree, UniformGrid };
+
+/**
+ * @brief Interface of the collision broadphase strategies
+ */
+class Broadphase {
+public:
+    virtual ~Broadphase() = default;
+
+    /**
+     * @brief Synchronize the internal structure with this step's proxies
+     * @param proxies Every active collider with its world AABB
+     */
+    virtual void update(const std::vector<BroadphaseProxy> &proxies) = 0;
+
+    /**
+     * @brief Collect all pairs whose AABBs overlap, each pair exactly once
+     *
+     * Pairs rejected by can_pair are never reported.
+     * @param pairs [out] Candidate pairs, appended
+     */
+    virtual void find_pairs(std::vector<BroadphasePair> &pairs) = 0;
+};
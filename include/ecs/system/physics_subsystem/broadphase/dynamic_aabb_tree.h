@@ -0,0 +1,97 @@
+#pragma once
+
+#include <ecs/system/physics_subsystem/broadphase/broadphase.h>
+
+/**
+ * @brief Dynamic bounding volume hierarchy over fat AABBs
+ *
+ * Leaves store an enlarged ("fat") box so that small motions do not touch the tree. Leaves are inserted at the
+ * sibling of minimal surface-area cost, removed in constant time, and every ancestor on the way up is refitted and
+ * rebalanced with tree rotations.
+ */
+class DynamicAabbTree {
+public:
+    constexpr static int null_node = -1;
+
+    explicit DynamicAabbTree(float margin = 0.1f);
+
+    /**
+     * @brief Insert a leaf for the given bounds
+     * @param aabb Tight bounds of the object
+     * @param user_data Index owned by the caller, returned by get_user_data
+     * @return Id of the created leaf
+     */
+    int create_proxy(const AABB &aabb, int user_data);
+
+    void destroy_proxy(int proxy);
+
+    /**
+     * @brief Update a leaf after its object moved
+     * @param proxy Leaf id
+     * @param aabb New tight bounds
+     * @param displacement Motion since the last update, used to predict the fat bounds
+     * @return true if the leaf had to be reinserted, false if it still fits its fat bounds
+     */
+    bool move_proxy(int proxy, const AABB &aabb, const glm::vec3 &displacement);
+
+    [[nodiscard]] int get_user_data(int proxy) const { return m_nodes[proxy].user_data; }
+
+    [[nodiscard]] const AABB &get_fat_aabb(int proxy) const { return m_nodes[proxy].aabb; }
+
+    [[nodiscard]] bool empty() const { return m_root == null_node; }
+
+    /**
+     * @brief Visit every leaf whose fat bounds overlap the query box
+     * @param aabb Query box
+     * @param callback Called with the leaf id, return false to stop the query
+     */
+    template <typename Callback> void query(const AABB &aabb, Callback &&callback) const {
+        std::vector<int> stack;
+        stack.reserve(64);
+        stack.push_back(m_root);
+        while (!stack.empty()) {
+            const int id = stack.back();
+            stack.pop_back();
+            if (id == null_node)
+                continue;
+            const Node &node = m_nodes[id];
+            if (!node.aabb.overlaps(aabb))
+                continue;
+            if (node.is_leaf()) {
+                if (!callback(id))
+                    return;
+            } else {
+                stack.push_back(node.child1);
+                stack.push_back(node.child2);
+            }
+        }
+    }
+
+private:
+    struct Node {
+        AABB aabb;
+        int user_data = -1;
+        int parent    = null_node; // Next free node while on the free list
+        int child1    = null_node;
+        int child2    = null_node;
+        int height    = -1; // Leaf = 0, free node = -1
+
+        [[nodiscard]] bool is_leaf() const { return child1 == null_node; }
+    };
+
+    std::vector<Node> m_nodes;
+    int m_root      = null_node;
+    int m_free_list = null_node;
+    float m_margin;
+    constexpr static float displacement_multiplier = 2.0f;
+
+    int allocate_node();
+
+    void free_node(int node);
+
+    void insert_leaf(int leaf);
+
+    void remove_leaf(int leaf);
+
+    int balance(int node);
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <ecs/system/physics_subsystem/broadphase/broadphase.h>
+#include <unordered_map>
+
+/**
+ * @brief Sweep-and-prune broadphase
+ *
+ * Keeps the proxies sorted by their lower bound on one axis across steps. Since bodies move little between frames
+ * the order is nearly preserved, so an insertion sort restores it in close to linear time. The sweep axis is the
+ * one along which the proxy centers have the largest variance, re-evaluated every step.
+ */
+class SweepAndPrune : public Broadphase {
+public:
+    void update(const std::vector<BroadphaseProxy> &proxies) override;
+
+    void find_pairs(std::vector<BroadphasePair> &pairs) override;
+
+private:
+    std::vector<BroadphaseProxy> m_sorted;
+    std::unordered_map<entt::entity, size_t> m_lookup;
+    std::vector<bool> m_seen;
+    int m_axis      = 0;
+    int m_sort_axis = -1;
+
+    /**
+     * @brief Restore the order along the sweep axis
+     * @param kept Proxies before this index were sorted last step, the ones after it are new
+     */
+    void sort(size_t kept);
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <ecs/system/physics_subsystem/broadphase/broadphase.h>
+
+/**
+ * @brief Spatial-hash grid broadphase for dense scenes of similarly sized bodies
+ *
+ * Rebuilt from scratch every step: each proxy emits one (cell key, proxy) entry per cell it touches, the entries
+ * are ordered with a parallel radix sort, and every run of equal keys is a cell whose pairs are generated in
+ * parallel. A pair sharing several cells is only reported by the cell holding the lower corner of the overlap of
+ * the two boxes. Proxies spanning too many cells, like the ground, are kept out of the grid and tested directly.
+ */
+class UniformGridBroadphase : public Broadphase {
+public:
+    /**
+     * @param cell_size Edge length of a cell, 0 derives it every step from the average proxy size
+     */
+    explicit UniformGridBroadphase(float cell_size = 0.0f);
+
+    void update(const std::vector<BroadphaseProxy> &proxies) override;
+
+    void find_pairs(std::vector<BroadphasePair> &pairs) override;
+
+private:
+    struct CellEntry {
+        uint64_t key;
+        uint32_t proxy;
+    };
+
+    float m_cell_size;
+    float m_current_cell_size = 1.0f;
+    std::vector<BroadphaseProxy> m_proxies;
+    std::vector<uint32_t> m_large_proxies;
+    std::vector<size_t> m_entry_offsets;
+    std::vector<CellEntry> m_entries;
+    std::vector<CellEntry> m_scratch;
+    std::vector<size_t> m_cell_starts;
+    std::vector<std::vector<BroadphasePair>> m_chunk_pairs;
+    constexpr static size_t max_cells_per_proxy = 512;
+
+    [[nodiscard]] glm::ivec3 cell_of(const glm::vec3 &point) const;
+
+    static uint64_t cell_key(const glm::ivec3 &cell);
+
+    void build_entries();
+
+    void radix_sort();
+};
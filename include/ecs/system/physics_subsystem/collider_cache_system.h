@@ -0,0 +1,31 @@
+#pragma once
+
+#include <ecs/component/collider.h>
+#include <ecs/component/collider_cache.h>
+#include <ecs/component/transform.h>
+#include <ecs/system/physics_subsystem/physics_subsystem.h>
+
+/**
+ * @brief Keeps the ColliderCache of every active collider in sync with its transform and shape
+ *
+ * Only colliders whose world transform or collider version changed since their last refresh are recomputed.
+ * Colliders added, replaced or patched through the registry get their version bumped by the system, see
+ * Collider::version.
+ */
+class ColliderCacheSystem : public PhysicsSubsystem {
+public:
+    [[nodiscard]] int execution_priority() const override;
+
+    void update(entt::registry &registry, float dt) override;
+
+private:
+    /**
+     * @brief Construct and update listener, moves the collider version past the one its cache was built from
+     */
+    static void bump_version(entt::registry &registry, entt::entity entity);
+
+    // After rigid body integration, before collision and cloth
+    constexpr static int priority = 8;
+    std::vector<entt::entity> entities;                // Colliders to refresh this step
+    const entt::registry *observed_registry = nullptr; // Registry the listeners are connected to
+};
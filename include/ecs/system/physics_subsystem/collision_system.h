@@ -1,16 +1,16 @@
 #pragma once
 
 #include <ecs/component/collider.h>
-#include <ecs/component/transform.h>
+#include <ecs/component/collider_cache.h>
+#include <ecs/system/physics_subsystem/broadphase/broadphase.h>
 #include <ecs/system/physics_subsystem/physics_subsystem.h>
+#include <memory>
+#include <unordered_map>
+
+struct RigidBody;
 
 class CollisionSystem : public PhysicsSubsystem {
 public:
-    [[nodiscard]] int execution_priority() const override;
-
-    void update(entt::registry &registry, float dt) override;
-
-private:
     /**
      * @brief Collision manifold containing collision resolution data
      */
@@ -20,58 +20,400 @@ private:
         float penetration_depth;    // Overlap distance between objects
         float combined_friction;    // Mixed friction coefficient
         float combined_restitution; // Mixed bounce coefficient
+        uint32_t feature_id;        // Contact feature (e.g. SAT axis) used to match contacts across frames
     };
+
+    explicit CollisionSystem(BroadphaseType broadphase_type = BroadphaseType::SweepAndPrune);
+
+    [[nodiscard]] int execution_priority() const override;
+
+    void update(entt::registry &registry, float dt) override;
+
+    /**
+     * @brief Switch the broadphase strategy, e.g. when loading a scene with a different layout
+     * @param type Strategy to use from the next step on
+     */
+    void set_broadphase(BroadphaseType type);
+
+    /**
+     * @brief Set the number of velocity iterations the contact solver runs per step
+     * @param iterations More iterations converge stacks better at a linear cost, clamped to at least 1
+     */
+    void set_solver_iterations(int iterations);
+
+    /**
+     * @brief Detect collision between two colliders
+     * @param a_c Collider of first entity
+     * @param a_w World cache of first entity
+     * @param b_c Collider of second entity
+     * @param b_w World cache of second entity
+     * @param out [out] Collision manifold with resolution data, normal pointing from a to b
+     * @return true if collision detected, false otherwise
+     */
+    static bool collide(const Collider &a_c, const ColliderCache &a_w, const Collider &b_c, const ColliderCache &b_w,
+                        CollisionManifold &out);
+
+private:
     struct CollisionPair {
         entt::entity a;
         entt::entity b;
         CollisionManifold manifold;
     };
+    /**
+     * @brief Identifies a contact across frames: ordered entity pair plus the feature that produced it
+     */
+    struct ContactKey {
+        entt::entity a;
+        entt::entity b;
+        uint32_t feature;
+
+        bool operator==(const ContactKey &other) const = default;
+    };
+    struct ContactKeyHash {
+        size_t operator()(const ContactKey &key) const {
+            size_t hash = entt::to_integral(key.a);
+            hash        = hash * 0x9E3779B1u ^ entt::to_integral(key.b);
+            hash        = hash * 0x9E3779B1u ^ key.feature;
+            return hash;
+        }
+    };
+    /**
+     * @brief Impulses accumulated by the solver, carried over to warm start the next step
+     */
+    struct ContactImpulse {
+        float normal_impulse;
+        glm::vec3 tangent_impulse; // World space, re-projected onto the new tangent basis
+    };
+    /**
+     * @brief Per-step solver state of a single contact point
+     */
+    struct ContactConstraint {
+        entt::entity a;
+        entt::entity b;
+        uint32_t feature;
+        RigidBody *rb_a;
+        RigidBody *rb_b;
+        float inv_mass_a;
+        float inv_mass_b;
+        glm::mat3 inv_inertia_a;
+        glm::mat3 inv_inertia_b;
+        glm::vec3 r_a;
+        glm::vec3 r_b;
+        glm::vec3 normal;
+        glm::vec3 tangents[2];
+        float normal_mass;
+        float tangent_mass[2];
+        float friction;
+        float velocity_bias;
+        float penetration_depth;
+        float normal_impulse;
+        float tangent_impulse[2];
+    };
+    /**
+     * @brief Contiguous range of contacts whose dynamic bodies only touch each other
+     */
+    struct Island {
+        size_t begin;
+        size_t end;
+    };
+    /**
+     * @brief Candidate pair waiting for a batched narrowphase kernel
+     */
+    struct BatchedPair {
+        entt::entity a;
+        entt::entity b;
+        const Collider *collider_a; // First shape of the kernel, which may be entity b
+        const Collider *collider_b;
+        const ColliderCache *cache_a;
+        const ColliderCache *cache_b;
+        bool flipped; // Kernel shapes are swapped relative to the entity pair
+    };
+    /**
+     * @brief Per-chunk buckets of candidate pairs sorted by shape combination
+     */
+    struct NarrowphaseBatches {
+        std::vector<BatchedPair> sphere_sphere;
+        std::vector<BatchedPair> sphere_box;
+        std::vector<BatchedPair> capsule_capsule;
+    };
     std::vector<CollisionPair> collision_pairs;
+    std::vector<BroadphasePair> trigger_pairs; // Overlaps involving a trigger, kept out of the solver
+    std::vector<std::vector<CollisionPair>> chunk_pairs;
+    std::vector<std::vector<BroadphasePair>> chunk_triggers;
+    std::vector<NarrowphaseBatches> chunk_batches;
+    /**
+     * @brief Separating axis that decided a box pair, tested first on the next step
+     */
+    struct CachedAxis {
+        entt::entity a;
+        entt::entity b;
+        uint32_t axis;
+
+        bool operator<(const CachedAxis &other) const { return a != other.a ? a < other.a : b < other.b; }
+    };
+    std::vector<std::vector<CachedAxis>> chunk_axes;
+    // Box pairs of the last step with their separating or minimum penetration axis, sorted by entities so the
+    // narrowphase finds them by binary search
+    std::vector<CachedAxis> box_axes;
+    std::vector<CachedAxis> previous_box_axes;
+    /**
+     * @brief Candidate pair of a fast body, swept from its previous to its current position
+     */
+    struct SweptPair {
+        entt::entity body;
+        entt::entity other;
+        float time_of_impact; // Fraction of the step's motion, 1 if the sweep touches nothing
+    };
+    /**
+     * @brief Collider pair touching in a step, sorted by entities to diff against the previous step
+     */
+    struct TouchingPair {
+        entt::entity a;
+        entt::entity b;
+        bool is_trigger;
+        uint32_t pair_index; // Into collision_pairs, UINT32_MAX for triggers and pairs kept while asleep
+    };
+    std::vector<TouchingPair> touching_pairs;
+    std::vector<TouchingPair> previous_touching_pairs;
+    std::vector<entt::entity> fast_bodies; // Sorted, awake fast bodies of this step
+    std::vector<SweptPair> swept_pairs;
+    std::vector<ContactConstraint> contacts;
+    std::vector<ContactConstraint> sorted_contacts;
+    std::vector<Island> islands;
+    std::unordered_map<entt::entity, uint32_t> body_nodes;
+    std::vector<uint32_t> body_parents;
+    std::vector<uint32_t> contact_islands;
+    std::vector<uint8_t> island_awake;
+    std::vector<entt::entity> node_entities;
+    // Sleeping bodies by island representative, so touching one body wakes the whole island
+    std::unordered_map<entt::entity, entt::entity> sleeping_island_of;
+    std::unordered_map<entt::entity, std::vector<entt::entity>> sleeping_islands;
+    std::unordered_map<ContactKey, ContactImpulse, ContactKeyHash> contact_cache;
+    std::unique_ptr<Broadphase> broadphase;
+    std::vector<BroadphaseProxy> proxies;
+    std::vector<BroadphaseProxy> planes; // Unbounded, paired with every moving proxy below them instead
+    std::vector<BroadphasePair> candidate_pairs;
     constexpr static int priority = 10;
+    // Smallest number of candidate pairs handed to one narrowphase task
+    constexpr static size_t narrowphase_grain = 64;
+    // Closing speeds below this do not bounce, which keeps resting contacts from jittering
+    constexpr static float restitution_threshold = 1.0f;
+    int solver_iterations                        = 8;
+    // Overlap tests per smallest half extent of travel while sweeping a fast body, and their upper bound
+    constexpr static float toi_steps_per_extent = 2.0f;
+    constexpr static int max_toi_steps          = 64;
+    constexpr static int toi_refinements        = 10;
+
+    static std::unique_ptr<Broadphase> create_broadphase(BroadphaseType type);
 
     void detect_collisions(entt::registry &registry);
 
+    /**
+     * @brief Move fast bodies back along their motion to the first pose touching another collider
+     *
+     * Only the translation of the step is swept, against the other colliders at their end pose. The narrowphase
+     * afterwards finds the touching contact, and the solver removes the approaching velocity.
+     */
+    void advance_fast_bodies(entt::registry &registry);
+
+    /**
+     * @brief Earliest fraction of a motion at which a moving collider touches another one
+     * @param end World cache of the moving collider at the end of the motion
+     * @return 1 if it never does, or if the colliders already overlap at the start
+     */
+    static float time_of_impact(const Collider &c, const ColliderCache &end, const glm::vec3 &motion,
+                                const Collider &other_c, const ColliderCache &other_w);
+
+    /**
+     * @brief World cache of a collider moved by an offset without changing its orientation
+     */
+    static ColliderCache translated(const ColliderCache &cache, const glm::vec3 &offset);
+
+    /**
+     * @brief Queue the pair for a batched kernel if one exists for its shape combination
+     * @return false if the pair has to go through the scalar collide
+     */
+    static bool enqueue_batched(const BatchedPair &pair, NarrowphaseBatches &batches);
+
+    /**
+     * @brief Run the batched kernels over all queued pairs and append the hits
+     */
+    static void collide_batched(const NarrowphaseBatches &batches, std::vector<CollisionPair> &out);
+
     void resolve_collisions(entt::registry &registry, float dt);
 
     /**
-     * @brief Detect collision between two colliders
-     * @param a_t Transform of first entity
-     * @param a_c Collider of first entity
-     * @param b_t Transform of second entity
-     * @param b_c Collider of second entity
-     * @param out [out] Collision manifold with resolution data
-     * @return true if collision detected, false otherwise
+     * @brief Report begin, stay and end events by diffing this step's touching pairs against the previous step's
+     *
+     * Pairs involving a sleeping body leave the broadphase but keep touching, so they are carried over silently
+     * until the body wakes up.
      */
-    static bool collide(const Transform &a_t, const Collider &a_c, const Transform &b_t, const Collider &b_c,
-                        CollisionManifold &out);
+    void publish_contact_events(entt::registry &registry);
+
+    /**
+     * @brief Wake sleeping islands touched by an awake body this step
+     */
+    void wake_touched_islands(entt::registry &registry);
+
+    /**
+     * @brief Wake every body of the sleeping island containing entity
+     */
+    void wake_island(entt::registry &registry, entt::entity entity);
+
+    /**
+     * @brief Forget island membership of bodies woken outside wake_island, e.g. by add_force, or destroyed
+     *
+     * Their islands keep the members that are still asleep, so a later wake_island never meets a stale entry.
+     */
+    void detach_woken_bodies(entt::registry &registry);
+
+    /**
+     * @brief Advance sleep timers and put islands to sleep once all their bodies have been resting long enough
+     */
+    void update_sleep(entt::registry &registry, float dt);
+
+    /**
+     * @brief Build solver constraints from this step's manifolds and load cached impulses
+     */
+    void prepare_contacts(entt::registry &registry);
+
+    /**
+     * @brief Group contacts into islands with union-find over their dynamic bodies
+     *
+     * Static and kinematic bodies do not link islands, otherwise everything resting on the ground would merge.
+     * Contacts are reordered so that each island is a contiguous range, in order of first appearance.
+     */
+    void build_islands();
+
+    static uint32_t find_root(std::vector<uint32_t> &parents, uint32_t node);
+
+    /**
+     * @brief Warm start, iterate and position-correct one island, independent of all others
+     */
+    void solve_island(entt::registry &registry, const Island &island);
+
+    /**
+     * @brief Apply the impulses carried over from the previous step
+     */
+    void warm_start(size_t begin, size_t end);
+
+    /**
+     * @brief One sequential-impulse pass over a range of contacts with accumulated impulse clamping
+     */
+    void solve_velocities(size_t begin, size_t end);
+
+    /**
+     * @brief Store accumulated impulses so matching contacts can be warm started next step
+     */
+    void store_impulses();
+
+    /**
+     * @brief Push penetrating bodies apart and refresh their world cache
+     */
+    void correct_positions(entt::registry &registry, size_t begin, size_t end);
+
+    /**
+     * @brief Carry the children of bodies moved by this system along and refresh their world cache
+     *
+     * The hierarchy was propagated before the sweeps and the solver moved their parents, so without this the
+     * children would trail by one step.
+     */
+    static void follow_moved_parents(entt::registry &registry);
+
+    static void apply_impulse(ContactConstraint &contact, const glm::vec3 &impulse);
+
+    static glm::vec3 relative_velocity(const ContactConstraint &contact);
 
     // Collision detection primitives
-    static bool sphere_vs_sphere(const Transform &a_t, const Collider &a_c, const Transform &b_t, const Collider &b_c,
-                                 CollisionManifold &out);
+    static bool sphere_vs_sphere(const Collider &a_c, const ColliderCache &a_w, const Collider &b_c,
+                                 const ColliderCache &b_w, CollisionManifold &out);
+
+    static bool sphere_vs_box(const Collider &sphere_c, const ColliderCache &sphere_w, const Collider &box_c,
+                              const ColliderCache &box_w, CollisionManifold &out);
+
+    static bool sphere_vs_capsule(const Collider &sphere_c, const ColliderCache &sphere_w, const Collider &capsule_c,
+                                  const ColliderCache &capsule_w, CollisionManifold &out);
+
+    /**
+     * @brief Separating axis test over the 15 face and edge axes
+     * @param axis_hint [in, out] Axis tested first, e.g. the one that decided the same pair last step. Receives the
+     * separating axis, or the minimum penetration axis if the boxes overlap.
+     */
+    static bool box_vs_box(const Collider &a_c, const ColliderCache &a_w, const Collider &b_c, const ColliderCache &b_w,
+                           CollisionManifold &out, uint32_t *axis_hint = nullptr);
+
+    static bool box_vs_capsule(const Collider &box_c, const ColliderCache &box_w, const Collider &capsule_c,
+                               const ColliderCache &capsule_w, CollisionManifold &out);
 
-    static bool sphere_vs_box(const Transform &sphere_t, const Collider &sphere_c, const Transform &box_t,
-                              const Collider &box_c, CollisionManifold &out);
+    static bool capsule_vs_capsule(const Collider &a_c, const ColliderCache &a_w, const Collider &b_c,
+                                   const ColliderCache &b_w, CollisionManifold &out);
 
-    static bool sphere_vs_capsule(const Transform &sphere_t, const Collider &sphere_c, const Transform &capsule_t,
-                                  const Collider &capsule_c, CollisionManifold &out);
+    /**
+     * @brief GJK/EPA fallback for any pair involving a convex hull
+     */
+    static bool convex_vs_convex(const Collider &a_c, const ColliderCache &a_w, const Collider &b_c,
+                                 const ColliderCache &b_w, CollisionManifold &out);
 
-    static bool box_vs_box(const Transform &a_t, const Collider &a_c, const Transform &b_t, const Collider &b_c,
-                           CollisionManifold &out);
+    /**
+     * @brief Deepest contact between a static triangle mesh and any other non-mesh shape
+     *
+     * The feature id is the triangle index, so contacts on different triangles are warm started separately.
+     */
+    static bool mesh_vs_convex(const Collider &mesh_c, const ColliderCache &mesh_w, const Collider &other_c,
+                               const ColliderCache &other_w, CollisionManifold &out);
 
-    static bool box_vs_capsule(const Transform &box_t, const Collider &box_c, const Transform &capsule_t,
-                               const Collider &capsule_c, CollisionManifold &out);
+    /**
+     * @brief Deepest contact between a heightfield and a sphere, box, capsule or hull, like mesh_vs_convex
+     *
+     * Round shapes whose core is below a triangle are pushed out upwards, everything below the surface is solid.
+     */
+    static bool heightfield_vs_convex(const Collider &field_c, const ColliderCache &field_w, const Collider &other_c,
+                                      const ColliderCache &other_w, CollisionManifold &out);
 
-    static bool capsule_vs_capsule(const Transform &a_t, const Collider &a_c, const Transform &b_t, const Collider &b_c,
-                                   CollisionManifold &out);
+    /**
+     * @brief Deepest contact between the children of a compound and any other shape
+     *
+     * Only children whose bounds overlap the other shape are tested, each with its own friction and restitution.
+     * The feature id mixes in the child index, so contacts on different children are warm started separately.
+     */
+    static bool compound_vs_shape(const Collider &compound_c, const ColliderCache &compound_w,
+                                  const Collider &other_c, const ColliderCache &other_w, CollisionManifold &out);
+
+    /**
+     * @brief Contact of the deepest point of a sphere, box, capsule or hull below a plane
+     */
+    static bool plane_vs_convex(const Collider &plane_c, const ColliderCache &plane_w, const Collider &other_c,
+                                const ColliderCache &other_w, CollisionManifold &out);
+
+    /**
+     * @brief Shared body of mesh_vs_convex and heightfield_vs_convex over any source of triangles
+     * @param triangles Provides query(min, max, callback) and get_triangle(index) in collider space
+     * @param solid_below Resolve round shapes below a triangle along its normal instead of through it
+     */
+    template <typename Triangles>
+    static bool triangles_vs_convex(const Triangles &triangles, bool solid_below, const Collider &mesh_c,
+                                    const ColliderCache &mesh_w, const Collider &other_c,
+                                    const ColliderCache &other_w, CollisionManifold &out);
+
+    /**
+     * @brief Deepest contact between a distance field and the core points of another shape
+     *
+     * Spheres and capsules are sampled along their core, boxes and hulls at their corners, so a box edge resting
+     * on a convex field region is only caught through its ends.
+     */
+    static bool sdf_vs_convex(const Collider &sdf_c, const ColliderCache &sdf_w, const Collider &other_c,
+                              const ColliderCache &other_w, CollisionManifold &out);
 
     // Geometric utilities
     static glm::vec3 closest_point_on_line_segment(const glm::vec3 &point, const glm::vec3 &a, const glm::vec3 &b);
 
+    static std::pair<glm::vec3, glm::vec3> closest_points_segment_triangle(const glm::vec3 &p0, const glm::vec3 &p1,
+                                                                           const glm::vec3 &a, const glm::vec3 &b,
+                                                                           const glm::vec3 &c);
+
     static std::pair<glm::vec3, glm::vec3> closest_points_between_lines(const glm::vec3 &a1, const glm::vec3 &a2,
                                                                         const glm::vec3 &b1, const glm::vec3 &b2);
 
-    static void get_capsule_endpoints(const Transform &t, const Collider &c, glm::vec3 &base, glm::vec3 &top);
-
     static std::pair<float, float> find_min(const glm::vec3 &point, const glm::vec3 &seg_start,
                                             const glm::vec3 &seg_end);
 };
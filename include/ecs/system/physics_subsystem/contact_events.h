@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Change in the touching state of a collider pair, reported once per physics step
+ */
+struct ContactEvent {
+    enum Type : uint8_t {
+        BEGIN, // First step the pair touches
+        STAY,  // Still touching
+        END    // No longer touching, or one of the entities was destroyed
+    };
+
+    Type type;
+    bool is_trigger; // One of the colliders is a trigger volume, the pair is never resolved
+    entt::entity a;  // Lower entity id of the pair
+    entt::entity b;
+    glm::vec3 normal;        // Pointing from a to b, zero for end events and triggers
+    glm::vec3 contact_point; // World space, zero for end events and triggers
+    float penetration_depth;
+};
+
+/**
+ * @brief Contact events of the most recent physics steps
+ *
+ * Lives in the registry context and is filled by CollisionSystem, so gameplay code reads it as
+ * registry.ctx().get<ContactEvents>(). The last frame_count steps are kept in a ring of buffers whose capacity is
+ * reused, so reporting contacts allocates nothing once the buffers have grown, and a consumer that runs less often
+ * than the physics step can catch up on the steps it missed.
+ */
+class ContactEvents {
+public:
+    constexpr static size_t frame_count = 4;
+
+    /**
+     * @brief Events of a recent step
+     * @param age 0 for the last step, up to frame_count - 1 steps before it
+     */
+    [[nodiscard]] std::span<const ContactEvent> get_events(size_t age = 0) const;
+
+    /**
+     * @brief Number of steps reported so far, the step of get_events(age) is get_frame() - 1 - age
+     */
+    [[nodiscard]] uint64_t get_frame() const noexcept;
+
+    /**
+     * @brief Start the events of a new step, dropping the oldest one
+     */
+    void begin_frame();
+
+    void push(const ContactEvent &event);
+
+private:
+    std::array<std::vector<ContactEvent>, frame_count> m_frames;
+    uint64_t m_frame = 0;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Number of pairs tested together by the batched narrowphase kernels
+ *
+ * The kernels are plain fixed-width loops over structure-of-arrays lanes that pick between results with mask selects
+ * instead of branches, so the compiler vectorizes them: two SSE/NEON registers per lane array, or one AVX register
+ * with TINY_SIMULATOR_AVX2. A single branch is enough to make a loop scalar again, -fopt-info-vec reports it.
+ */
+constexpr size_t batch_width = 8;
+
+struct SphereLanes {
+    alignas(32) float x[batch_width];
+    alignas(32) float y[batch_width];
+    alignas(32) float z[batch_width];
+    alignas(32) float radius[batch_width];
+};
+
+/**
+ * @brief Oriented boxes as world matrix columns (3 basis + translation) and inverse matrix columns
+ */
+struct BoxLanes {
+    alignas(32) float matrix[12][batch_width];
+    alignas(32) float inverse[12][batch_width];
+    alignas(32) float half_x[batch_width];
+    alignas(32) float half_y[batch_width];
+    alignas(32) float half_z[batch_width];
+};
+
+struct CapsuleLanes {
+    alignas(32) float base_x[batch_width];
+    alignas(32) float base_y[batch_width];
+    alignas(32) float base_z[batch_width];
+    alignas(32) float top_x[batch_width];
+    alignas(32) float top_y[batch_width];
+    alignas(32) float top_z[batch_width];
+    alignas(32) float radius[batch_width];
+};
+
+/**
+ * @brief Kernel results, lanes with hit == 0 hold unspecified values
+ */
+struct ContactLanes {
+    alignas(32) float normal_x[batch_width]; // Pointing from the first shape to the second
+    alignas(32) float normal_y[batch_width];
+    alignas(32) float normal_z[batch_width];
+    alignas(32) float point_x[batch_width];
+    alignas(32) float point_y[batch_width];
+    alignas(32) float point_z[batch_width];
+    alignas(32) float depth[batch_width];
+    alignas(32) uint32_t hit[batch_width];
+};
+
+/**
+ * @brief Test batch_width sphere pairs, matching CollisionSystem::sphere_vs_sphere
+ */
+void collide_sphere_sphere(const SphereLanes &a, const SphereLanes &b, ContactLanes &out);
+
+/**
+ * @brief Test batch_width sphere-box pairs, matching CollisionSystem::sphere_vs_box
+ */
+void collide_sphere_box(const SphereLanes &sphere, const BoxLanes &box, ContactLanes &out);
+
+/**
+ * @brief Test batch_width capsule pairs, matching CollisionSystem::capsule_vs_capsule
+ */
+void collide_capsule_capsule(const CapsuleLanes &a, const CapsuleLanes &b, ContactLanes &out);
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <ecs/component/collider.h>
+#include <ecs/component/collider_cache.h>
+
+/**
+ * @brief Collider in world space seen only through its support function
+ */
+struct ConvexShape {
+    const Collider *collider;
+    const ColliderCache *cache;
+    mutable uint32_t hint     = 0;       // Last hull support vertex, seeds the next hill climb
+    const glm::vec3 *triangle = nullptr; // Three world-space corners, replaces the collider when set
+
+    /**
+     * @brief Furthest point of the shape along a direction, in world space
+     */
+    [[nodiscard]] glm::vec3 support(const glm::vec3 &direction) const;
+
+    /**
+     * @brief Any point inside the shape, used to seed the search direction
+     */
+    [[nodiscard]] glm::vec3 center() const;
+};
+
+struct ConvexContact {
+    glm::vec3 normal; // From the first shape to the second
+    glm::vec3 point;
+    float depth;
+};
+
+/**
+ * @brief Intersect two convex shapes with GJK and find the penetration with EPA
+ * @param a First shape
+ * @param b Second shape
+ * @param contact [out] Minimum translation and contact point if the shapes overlap
+ * @return true if the shapes overlap by more than touching
+ */
+bool gjk_epa(const ConvexShape &a, const ConvexShape &b, ConvexContact &contact);
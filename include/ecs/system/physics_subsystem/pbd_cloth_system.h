@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ecs/component/collider.h>
+#include <ecs/component/collider_cache.h>
 #include <ecs/system/physics_subsystem/physics_subsystem.h>
 
 class PBDClothSystem : public PhysicsSubsystem {
@@ -12,21 +13,43 @@ public:
 private:
     static void predict_positions(Cloth &cloth, float dt);
 
-    static void handle_collisions(Cloth &cloth, const Collider &collider, const Transform &collider_transform);
+    static void handle_collisions(Cloth &cloth, const Collider &collider, const ColliderCache &collider_cache);
 
     static void solve_constraints(Cloth &cloth);
 
     static void update_positions(Cloth &cloth, float dt);
 
-    static bool collide_sphere(const glm::vec3 &point, const Collider &collider, const Transform &transform,
+    static bool collide_point(const glm::vec3 &point, const Collider &collider, const ColliderCache &cache,
+                              glm::vec3 &surface_pos, glm::vec3 &normal);
+
+    static bool collide_sphere(const glm::vec3 &point, const Collider &collider, const ColliderCache &cache,
                                glm::vec3 &surface_pos, glm::vec3 &normal);
 
-    static bool collide_box(const glm::vec3 &point, const Collider &collider, const Transform &transform,
+    static bool collide_box(const glm::vec3 &point, const Collider &collider, const ColliderCache &cache,
                             glm::vec3 &surface_pos, glm::vec3 &normal);
 
-    static bool collide_capsule(const glm::vec3 &point, const Collider &collider, const Transform &transform,
+    static bool collide_capsule(const glm::vec3 &point, const Collider &collider, const ColliderCache &cache,
                                 glm::vec3 &surface_pos, glm::vec3 &normal);
 
+    static bool collide_convex_hull(const glm::vec3 &point, const Collider &collider, const ColliderCache &cache,
+                                    glm::vec3 &surface_pos, glm::vec3 &normal);
+
+    static bool collide_triangle_mesh(const glm::vec3 &point, const Collider &collider, const ColliderCache &cache,
+                                      glm::vec3 &surface_pos, glm::vec3 &normal);
+
+    static bool collide_signed_distance_field(const glm::vec3 &point, const Collider &collider,
+                                              const ColliderCache &cache, glm::vec3 &surface_pos, glm::vec3 &normal);
+
+    static bool collide_plane(const glm::vec3 &point, const Collider &collider, const ColliderCache &cache,
+                              glm::vec3 &surface_pos, glm::vec3 &normal);
+
+    static bool collide_height_field(const glm::vec3 &point, const Collider &collider, const ColliderCache &cache,
+                                     glm::vec3 &surface_pos, glm::vec3 &normal);
+
+    static bool collide_compound(const glm::vec3 &point, const Collider &collider, const ColliderCache &cache,
+                                 glm::vec3 &surface_pos, glm::vec3 &normal);
+
     constexpr static int priority          = 15;
     constexpr static int solver_iterations = 3;
+    constexpr static float mesh_thickness  = 0.01f; // Distance kept from meshes, distance fields and terrain
 };
@@ -2,6 +2,7 @@
 
 #include <ecs/system/physics_subsystem/physics_subsystem.h>
 #include <glm/glm.hpp>
+#include <vector>
 
 class RigidBodySystem : public PhysicsSubsystem {
 public:
@@ -10,8 +11,51 @@ public:
     void update(entt::registry &registry, float dt) override;
 
 private:
-    constexpr static int priority = 5;
-    glm::vec3 gravity             = glm::vec3(0.0f, -9.81f, 0.0f);
+    constexpr static size_t lane_width = 8; // Bodies integrated together, one AVX or two SSE/NEON registers
+
+    /**
+     * @brief lane_width dynamic bodies in structure-of-arrays form
+     *
+     * Like the batched narrowphase kernels, the integration loop runs over fixed-width lanes without branches on
+     * lane data and is built with VECTORIZE_OPTIONS, so the compiler vectorizes it.
+     */
+    struct BodyLanes {
+        alignas(32) float position[3][lane_width];
+        alignas(32) float orientation[4][lane_width]; // Quaternion x, y, z, w
+        alignas(32) float linear_velocity[3][lane_width];
+        alignas(32) float angular_velocity[3][lane_width];
+        alignas(32) float force[3][lane_width];
+        alignas(32) float torque[3][lane_width];
+        alignas(32) float inverse_inertia[9][lane_width]; // Column-major
+        alignas(32) float inverse_mass[lane_width];
+        alignas(32) float linear_damping[lane_width];
+        alignas(32) float angular_damping[lane_width];
+        alignas(32) float gravity_scale[lane_width];   // 1 if the body uses gravity, 0 otherwise
+        alignas(32) float linear_free[3][lane_width];  // 0 on frozen position axes, 1 otherwise
+        alignas(32) float angular_free[3][lane_width]; // 0 on frozen rotation axes, 1 otherwise
+        bool rotates[lane_width];                      // Orientation may change and must be written back
+    };
+
+    constexpr static int priority           = 5;
+    constexpr static size_t integrate_grain = 32; // Batches per parallel chunk
+    glm::vec3 gravity                       = glm::vec3(0.0f, -9.81f, 0.0f);
+    std::vector<entt::entity> bodies;             // Dynamic bodies of the current step
+    std::vector<BodyLanes> batches;               // bodies[i] lives in lane i % lane_width of batch i / lane_width
 
     void integrate_forces(entt::registry &registry, float dt);
+
+    /**
+     * @brief Copy the bodies of a batch into its lanes, unused lanes hold a resting massless body
+     */
+    void gather(entt::registry &registry, size_t batch);
+
+    /**
+     * @brief Integrate velocities, positions and orientations of every lane, matching RigidBody::integrate
+     */
+    static void integrate_lanes(BodyLanes &lanes, float dt, const glm::vec3 &gravity);
+
+    /**
+     * @brief Write the lanes of a batch back to its bodies
+     */
+    void scatter(entt::registry &registry, size_t batch);
 };
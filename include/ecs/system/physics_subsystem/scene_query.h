@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cfloat>
+#include <ecs/component/collider.h>
+#include <ecs/component/transform.h>
+#include <ecs/system/physics_subsystem/broadphase/aabb.h>
+#include <entt/entt.hpp>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Batched raycasts, shape sweeps and overlap tests against the colliders of the last physics step
+ *
+ * Lives in the registry context and is rebuilt by SceneQuerySystem after every step, so gameplay code reads it as
+ * registry.ctx().get<SceneQuery>(). The collider bounds are snapshotted into a wide bounding volume hierarchy whose
+ * nodes hold node_width child boxes in structure-of-arrays lanes, tested against a ray in one fixed-width loop.
+ * Every query of a batch is independent, batches are split across the thread pool.
+ */
+class SceneQuery {
+public:
+    constexpr static size_t node_width = 8;
+
+    struct Ray {
+        glm::vec3 origin;
+        glm::vec3 direction;          // Need not be normalized
+        float max_distance = FLT_MAX; // In world units
+        uint32_t mask      = ~0u;     // Collider layers the ray hits
+    };
+
+    /**
+     * @brief Sphere (base == top) or capsule moved along a direction
+     */
+    struct Sweep {
+        glm::vec3 base; // Core segment of the swept shape at the start of the sweep
+        glm::vec3 top;
+        float radius;
+        glm::vec3 direction; // Need not be normalized
+        float max_distance = FLT_MAX;
+        uint32_t mask      = ~0u;
+    };
+
+    /**
+     * @brief Collider shape placed in the world by a transform, e.g. a trigger volume that has no entity
+     *
+     * Only colliders on a layer of collider.mask are reported.
+     */
+    struct Overlap {
+        Collider collider;
+        Transform transform;
+    };
+
+    struct Hit {
+        entt::entity entity;
+        float distance;   // Along the query direction, the negated penetration depth for overlaps
+        glm::vec3 point;  // World-space contact position
+        glm::vec3 normal; // Surface normal of the hit collider, facing the query
+    };
+
+    /**
+     * @brief Hits of a whole batch, stored back to back so one batch costs no allocation per query
+     */
+    struct Results {
+        std::vector<Hit> hits;         // Grouped by query, sorted by distance within each group
+        std::vector<uint32_t> offsets; // Hits of query i are hits[offsets[i] .. offsets[i + 1]]
+
+        [[nodiscard]] std::span<const Hit> of(size_t query) const {
+            return { hits.data() + offsets[query], hits.data() + offsets[query + 1] };
+        }
+
+        // Per-chunk buffers, kept to reuse their capacity across batches
+        std::vector<std::vector<Hit>> chunk_hits;
+    };
+
+    /**
+     * @brief Snapshot the bounds of every active collider and rebuild the hierarchy
+     *
+     * Nothing is rebuilt if the same colliders are active with the same cache versions and layers as on the last
+     * call, so a scene at rest only costs one pass over its colliders. If only bounds or layers changed, the existing
+     * hierarchy is refit instead of rebuilt, up to max_refits calls in a row.
+     */
+    void rebuild(const entt::registry &registry);
+
+    /**
+     * @brief Cast a batch of rays
+     * @param closest_only Keep only the nearest hit of each ray, which also prunes the traversal
+     */
+    void raycast(const entt::registry &registry, const std::vector<Ray> &rays, Results &results,
+                 bool closest_only = false) const;
+
+    /**
+     * @brief Sweep a batch of spheres and capsules
+     *
+     * Shapes overlapping a collider at the start of their sweep report it at distance 0.
+     * @param closest_only Keep only the first hit of each sweep
+     */
+    void sweep(const entt::registry &registry, const std::vector<Sweep> &sweeps, Results &results,
+               bool closest_only = false) const;
+
+    /**
+     * @brief Find every collider overlapping each shape of a batch, deepest first
+     */
+    void overlap(const entt::registry &registry, const std::vector<Overlap> &shapes, Results &results) const;
+
+private:
+    /**
+     * @brief node_width child boxes in lanes, unused lanes past count are never reported
+     */
+    struct Node {
+        alignas(32) float min_x[node_width];
+        alignas(32) float min_y[node_width];
+        alignas(32) float min_z[node_width];
+        alignas(32) float max_x[node_width];
+        alignas(32) float max_y[node_width];
+        alignas(32) float max_z[node_width];
+        int32_t child[node_width]; // Inner node index, or ~proxy for a single collider
+        uint32_t count;
+    };
+    /**
+     * @brief What the snapshot of one collider was taken from
+     */
+    struct Source {
+        entt::entity entity;
+        uint32_t transform_version; // See ColliderCache
+        uint32_t collider_version;
+        uint32_t layer;
+        bool unbounded; // Plane, kept out of the hierarchy
+
+        bool operator==(const Source &other) const = default;
+    };
+    // Enough for the balanced hierarchy of any collider count that fits in memory
+    constexpr static int max_stack = 256;
+    // Smallest number of queries handed to one task
+    constexpr static size_t query_grain = 32;
+    // Overlap tests per radius of travel while sweeping past a collider, and their upper bound
+    constexpr static float sweep_steps_per_radius = 4.0f;
+    constexpr static int max_sweep_steps          = 256;
+    constexpr static int sweep_refinements        = 12;
+    // Refits in a row before a full rebuild, the hierarchy degrades as colliders drift away from where it was built
+    constexpr static int max_refits = 120;
+
+    std::vector<Node> m_nodes; // Root first, empty if there are no colliders
+    std::vector<entt::entity> m_entities;
+    std::vector<AABB> m_bounds;
+    std::vector<uint32_t> m_layers;
+    std::vector<uint32_t> m_order;     // Proxy indices, partitioned during the build
+    std::vector<uint32_t> m_unbounded; // Proxies of planes, tested by every query instead of stored in the hierarchy
+    std::vector<Source> m_sources;     // Colliders of the last rebuild, in view order
+    std::vector<Source> m_next_sources;
+    int m_refits = 0; // Refits since the last full build
+
+    int32_t build(uint32_t begin, uint32_t end);
+
+    /**
+     * @brief Update the bounds and layers of the proxies in place and grow the node boxes around them
+     */
+    void refit(const entt::registry &registry);
+
+    /**
+     * @brief Visit every collider whose bounds, grown by inflate, a ray passes through
+     * @param callback Called as callback(proxy, max_distance), and may shorten max_distance to prune
+     */
+    template <typename Callback>
+    void traverse(const glm::vec3 &origin, const glm::vec3 &direction, float max_distance, const glm::vec3 &inflate,
+                  Callback &&callback) const;
+
+    /**
+     * @brief Visit every collider whose bounds overlap a box
+     */
+    template <typename Callback> void traverse(const AABB &aabb, Callback &&callback) const;
+
+    /**
+     * @brief Run one test per query on the thread pool and gather the hits of each query sorted by distance
+     * @param test Called as test(query, hits) and appends the hits of that query
+     */
+    template <typename Query, typename Test>
+    static void run_batch(const std::vector<Query> &queries, Results &results, bool closest_only, Test &&test);
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <ecs/system/physics_subsystem/physics_subsystem.h>
+#include <ecs/system/physics_subsystem/scene_query.h>
+
+/**
+ * @brief Keeps the SceneQuery in the registry context in sync with the colliders of the current step
+ */
+class SceneQuerySystem : public PhysicsSubsystem {
+public:
+    [[nodiscard]] int execution_priority() const override;
+
+    void update(entt::registry &registry, float dt) override;
+
+private:
+    // After the contact solver has moved the bodies for this step
+    constexpr static int priority = 12;
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <ecs/component/transform.h>
+#include <entt/entt.hpp>
+#include <vector>
+
+/**
+ * @brief Flattened parent links of all transforms, propagating world matrices from parents to children
+ *
+ * Lives in the registry context and is updated by TransformHierarchySystem early in every step. Systems that move
+ * bodies later in the step, like the contact solver, update it again so children follow within the same step.
+ * Every entity in a hierarchy is kept in a flat array sorted so each tree is contiguous with parents before their
+ * children. The array is rebuilt only when parent links change. Each update walks it in order, recomputing only
+ * nodes whose local transform or parent world matrix changed, and independent trees run in parallel.
+ */
+class TransformHierarchy {
+public:
+    /**
+     * @brief Pick up changed parent links and propagate every changed world matrix
+     */
+    void update(entt::registry &registry);
+
+    /**
+     * @brief Propagate the world matrices changed since the last update or propagate, keeping the parent links
+     */
+    void propagate(entt::registry &registry);
+
+    /**
+     * @brief Visit every child whose world matrix the last update or propagate recomputed
+     * @param callback Called as callback(entity)
+     */
+    template <typename Callback> void each_changed(const entt::registry &registry, Callback &&callback) const {
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            if (changed[i] && registry.get<Transform>(nodes[i].entity).parent != entt::null)
+                callback(nodes[i].entity);
+        }
+    }
+
+private:
+    /**
+     * @brief Child to parent link, the parent is entt::null if it no longer exists
+     */
+    struct Link {
+        entt::entity child;
+        entt::entity parent;
+
+        bool operator==(const Link &other) const = default;
+    };
+    struct Node {
+        entt::entity entity;
+        uint32_t parent;        // Index into nodes, UINT32_MAX for roots
+        uint32_t local_version; // Transform version the world matrix was computed from
+    };
+    struct Tree {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    constexpr static size_t propagate_grain = 16; // Trees per parallel chunk
+    constexpr static uint32_t stale_version = UINT32_MAX;
+
+    std::vector<Link> links; // Sorted by child, as seen by the last rebuild
+    std::vector<Link> current_links;
+    std::vector<Node> nodes; // Trees back to back, parents before children
+    std::vector<Tree> trees;
+    std::vector<glm::mat4> worlds;   // World matrix of each node, read by its children
+    std::vector<glm::mat4> inverses; // Inverse world matrix of each node
+    std::vector<uint8_t> changed;    // World matrix of the node was recomputed by the last pass
+
+    /**
+     * @brief Rebuild the flat node order from the links, dropping links that form cycles
+     */
+    void rebuild();
+
+    void propagate_tree(entt::registry &registry, const Tree &tree);
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <ecs/system/physics_subsystem/physics_subsystem.h>
+#include <ecs/system/physics_subsystem/transform_hierarchy.h>
+
+/**
+ * @brief Keeps the TransformHierarchy in the registry context and propagates world matrices once the bodies moved
+ */
+class TransformHierarchySystem : public PhysicsSubsystem {
+public:
+    [[nodiscard]] int execution_priority() const override;
+
+    void update(entt::registry &registry, float dt) override;
+
+private:
+    // After rigid body integration, before the collider caches read world matrices
+    constexpr static int priority = 7;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+class Model;
+
+/**
+ * @brief Convex hull of a point cloud, built once with quickhull and shared by every collider using it
+ *
+ * Besides the triangulated surface the hull keeps the vertex adjacency graph, so support queries can hill-climb
+ * from a previous result instead of scanning every vertex.
+ */
+class ConvexHull {
+public:
+    /**
+     * @brief Outward facing triangle, the plane is dot(normal, p) = offset
+     */
+    struct Face {
+        uint32_t indices[3];
+        glm::vec3 normal;
+        float offset;
+    };
+
+    /**
+     * @brief Build the hull of a point cloud
+     * @param points Input points, duplicates and interior points are fine
+     * @return Hull, or nullptr if the points are flat or fewer than four
+     */
+    static std::shared_ptr<ConvexHull> build(const std::vector<glm::vec3> &points);
+
+    /**
+     * @brief Build the hull of all vertex positions of a model, in model space
+     */
+    static std::shared_ptr<ConvexHull> from_model(const Model &model);
+
+    /**
+     * @brief Index of the vertex furthest along a direction
+     * @param direction Query direction in hull space, need not be normalized
+     * @param start Vertex to start climbing from, usually the previous result for a similar direction
+     */
+    [[nodiscard]] uint32_t support(const glm::vec3 &direction, uint32_t start = 0) const noexcept;
+
+    [[nodiscard]] const std::vector<glm::vec3> &get_vertices() const noexcept;
+
+    [[nodiscard]] const std::vector<Face> &get_faces() const noexcept;
+
+private:
+    std::vector<glm::vec3> m_vertices;
+    std::vector<Face> m_faces;
+    // Neighbors of vertex i are m_adjacency[m_adjacency_offsets[i] .. m_adjacency_offsets[i + 1]]
+    std::vector<uint32_t> m_adjacency_offsets;
+    std::vector<uint32_t> m_adjacency;
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+class Texture;
+
+/**
+ * @brief Regular grid of heights over the local x/z plane, two triangles per cell, solid below the surface
+ *
+ * The grid is centered on the origin in x and z with heights along +y. A pyramid of min/max heights, whose first
+ * level holds the range of every cell and each further level merges 2x2 blocks of the one below, lets box queries
+ * and raycasts skip whole regions of the grid that lie above or below them.
+ */
+class HeightField {
+public:
+    constexpr static int max_levels = 32;
+
+    /**
+     * @brief Build the field of a row-major grid of samples
+     * @param heights columns * rows heights in local units
+     * @param size Extent of the grid along x and z, size.y scales every height
+     * @return Field, or nullptr if the grid has fewer than 2x2 samples
+     */
+    static std::shared_ptr<HeightField> build(std::vector<float> heights, int columns, int rows,
+                                              const glm::vec3 &size);
+
+    /**
+     * @brief Field of the first channel of a texture, one sample per texel, a texel value of 1 is size.y high
+     */
+    static std::shared_ptr<HeightField> from_texture(const Texture &texture, const glm::vec3 &size);
+
+    /**
+     * @brief Field of a height map image loaded through the texture manager
+     */
+    static std::shared_ptr<HeightField> from_file(const std::filesystem::path &path, const glm::vec3 &size);
+
+    /**
+     * @brief Surface height and normal above a point of the x/z plane, in constant time
+     * @return false if the point lies outside the grid
+     */
+    bool height_at(float x, float z, float &height, glm::vec3 &normal) const noexcept;
+
+    /**
+     * @brief Visit every triangle whose cell range overlaps a box
+     * @param min Minimum corner of the box in field space
+     * @param max Maximum corner of the box in field space
+     * @param callback Called as callback(triangle_index)
+     */
+    template <typename Callback> void query(const glm::vec3 &min, const glm::vec3 &max, Callback &&callback) const {
+        Block stack[4 * max_levels];
+        int size      = 0;
+        stack[size++] = { static_cast<int>(m_levels.size()) - 1, 0, 0 };
+        while (size > 0) {
+            const Block block = stack[--size];
+            glm::vec3 block_min, block_max;
+            block_bounds(block, block_min, block_max);
+            if (block_min.x > max.x || block_max.x < min.x || block_min.y > max.y || block_max.y < min.y ||
+                block_min.z > max.z || block_max.z < min.z)
+                continue;
+            if (block.level == 0) {
+                const auto cell = static_cast<uint32_t>(block.row * (m_columns - 1) + block.column);
+                callback(cell * 2);
+                callback(cell * 2 + 1);
+                continue;
+            }
+            const Level &below = m_levels[block.level - 1];
+            for (int row = block.row * 2; row < std::min(block.row * 2 + 2, below.rows); ++row) {
+                for (int column = block.column * 2; column < std::min(block.column * 2 + 2, below.columns); ++column)
+                    stack[size++] = { block.level - 1, column, row };
+            }
+        }
+    }
+
+    /**
+     * @brief First triangle hit by a ray, walking the cells it passes front to back
+     * @param origin Ray origin in field space
+     * @param direction Ray direction in field space, distances are measured in multiples of it
+     * @param distance [out] Hit distance
+     * @param triangle [out] Triangle hit
+     */
+    bool raycast(const glm::vec3 &origin, const glm::vec3 &direction, float max_distance, float &distance,
+                 uint32_t &triangle) const noexcept;
+
+    /**
+     * @brief Corners of a triangle in field space, wound so their normal points up
+     */
+    [[nodiscard]] std::array<glm::vec3, 3> get_triangle(uint32_t triangle) const noexcept;
+
+    [[nodiscard]] glm::vec3 get_bounds_min() const noexcept;
+
+    [[nodiscard]] glm::vec3 get_bounds_max() const noexcept;
+
+    [[nodiscard]] int get_columns() const noexcept;
+
+    [[nodiscard]] int get_rows() const noexcept;
+
+private:
+    /**
+     * @brief Min/max heights of the blocks of one pyramid level, row-major
+     */
+    struct Level {
+        int columns;
+        int rows;
+        std::vector<glm::vec2> range;
+    };
+    struct Block {
+        int level;
+        int column;
+        int row;
+    };
+
+    int m_columns = 0;             // Samples along x
+    int m_rows    = 0;             // Samples along z
+    glm::vec2 m_origin{ 0.0f };    // x/z of the first sample
+    glm::vec2 m_cell_size{ 1.0f }; // x/z distance between samples
+    std::vector<float> m_heights;  // Row-major, already scaled
+    std::vector<Level> m_levels;   // Cells first, a single block covering the grid last
+
+    [[nodiscard]] glm::vec3 sample(int column, int row) const noexcept;
+
+    /**
+     * @brief Field-space box of a block, spanning its cells in x/z and its height range in y
+     */
+    void block_bounds(const Block &block, glm::vec3 &min, glm::vec3 &max) const noexcept;
+};
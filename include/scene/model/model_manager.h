@@ -1,8 +1,11 @@
 #pragma once
 
 #include <scene/model/async_model_loader.h>
+#include <scene/model/convex_hull.h>
 #include <scene/model/model.h>
 #include <scene/model/model_loader.h>
+#include <scene/model/signed_distance_field.h>
+#include <scene/model/triangle_mesh_bvh.h>
 #include <scene/resource/resource_manager.h>
 #include <thread>
 #include <unordered_map>
@@ -29,11 +32,35 @@ public:
 
     void enable_hot_reload(bool enable, std::chrono::seconds interval) override;
 
+    /**
+     * @brief Convex hull of a model for collision, loading the model if needed
+     * @param path Model path, same as for load_resource
+     * @return Hull in model space, built on first request and cached until the model is reloaded or evicted
+     */
+    std::shared_ptr<ConvexHull> get_convex_hull(const std::filesystem::path &path);
+
+    /**
+     * @brief Triangle BVH of a model for static mesh collision, loading the model if needed
+     * @param path Model path, same as for load_resource
+     * @return Hierarchy in model space, built on first request and cached until the model is reloaded or evicted
+     */
+    std::shared_ptr<TriangleMeshBVH> get_triangle_mesh(const std::filesystem::path &path);
+
+    /**
+     * @brief Signed distance field of a watertight model, loading the model if needed
+     * @param path Model path, same as for load_resource
+     * @return Field in model space, baked or read from the disk cache on first request and kept with the model
+     */
+    std::shared_ptr<SignedDistanceField> get_signed_distance_field(const std::filesystem::path &path);
+
 private:
     struct ModelRecord {
         std::shared_ptr<Model> model;
         std::chrono::system_clock::time_point last_access;
         std::filesystem::file_time_type last_write;
+        std::shared_ptr<ConvexHull> convex_hull;
+        std::shared_ptr<TriangleMeshBVH> triangle_mesh;
+        std::shared_ptr<SignedDistanceField> signed_distance_field;
     };
 
     std::unordered_map<std::string, ModelRecord> m_model_map;
@@ -33,6 +33,12 @@ private:
 
     static std::shared_ptr<Model> generate_capsule(const std::unordered_map<std::string, std::any> &params);
 
+    static std::shared_ptr<Model> generate_convex_hull(const std::unordered_map<std::string, std::any> &params);
+
+    static std::shared_ptr<Model> generate_triangle_mesh(const std::unordered_map<std::string, std::any> &params);
+
+    static std::shared_ptr<Model> generate_height_field(const std::unordered_map<std::string, std::any> &params);
+
     /**
      * @brief Calculates tangent vectors for normal mapping
      *
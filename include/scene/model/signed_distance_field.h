@@ -0,0 +1,65 @@
+#pragma once
+
+#include <filesystem>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+class Model;
+class TriangleMeshBVH;
+
+/**
+ * @brief Sparse signed distance field of a closed mesh, negative inside
+ *
+ * The domain is split into bricks of brick_size^3 cells. Only bricks within the narrow band of the surface store
+ * their samples; all others fall back to a coarse grid sampled at the brick corners, which is still exact enough to
+ * tell inside from outside. Each brick keeps its own boundary samples so a lookup never touches a neighbor brick.
+ */
+class SignedDistanceField {
+public:
+    constexpr static int brick_size    = 8;
+    constexpr static int brick_samples = (brick_size + 1) * (brick_size + 1) * (brick_size + 1);
+
+    /**
+     * @brief Bake the field of a triangle mesh, splitting the bricks across the thread pool
+     * @param mesh Closed, consistently wound mesh
+     * @param cell_size Edge length of a cell in mesh space
+     * @param band Bricks closer than this to the surface are stored at full resolution
+     */
+    static std::shared_ptr<SignedDistanceField> bake(const TriangleMeshBVH &mesh, float cell_size, float band);
+
+    /**
+     * @brief Field of all meshes of a model in model space, loaded from the disk cache when the mesh is unchanged
+     * @param model Watertight model
+     * @param resolution Number of cells along the longest side of the model
+     */
+    static std::shared_ptr<SignedDistanceField> from_model(const Model &model, int resolution = 64);
+
+    /**
+     * @brief Signed distance and its gradient at a point, trilinearly interpolated
+     * @param point Query point in mesh space, points outside the domain get a conservative estimate
+     * @param gradient [out] Gradient of the distance, roughly unit length near the surface
+     */
+    float sample(const glm::vec3 &point, glm::vec3 &gradient) const noexcept;
+
+    bool save(const std::filesystem::path &path) const;
+
+    static std::shared_ptr<SignedDistanceField> load(const std::filesystem::path &path, uint64_t hash);
+
+    [[nodiscard]] glm::vec3 get_bounds_min() const noexcept;
+
+    [[nodiscard]] glm::vec3 get_bounds_max() const noexcept;
+
+    [[nodiscard]] size_t get_brick_count() const noexcept;
+
+private:
+    uint64_t m_hash = 0; // Hash of the source mesh and bake settings
+    glm::vec3 m_origin{ 0.0f };
+    float m_cell_size = 1.0f;
+    glm::ivec3 m_brick_dims{ 0 };
+    glm::vec3 m_bounds_min{ 0.0f }; // Bounds of the source mesh
+    glm::vec3 m_bounds_max{ 0.0f };
+    std::vector<float> m_coarse;        // Distance at every brick corner
+    std::vector<uint32_t> m_brick_slot; // First sample of each brick in m_samples, UINT32_MAX if not stored
+    std::vector<float> m_samples;
+};
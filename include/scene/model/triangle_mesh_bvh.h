@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+class Model;
+
+/**
+ * @brief Bounding volume hierarchy over the triangles of a static mesh, built once with a binned SAH
+ *
+ * Triangles are reordered so every leaf references a contiguous run of them, and the two children of an inner node
+ * are stored next to each other, which keeps a node at 32 bytes (two per cache line).
+ */
+class TriangleMeshBVH {
+public:
+    struct Node {
+        glm::vec3 min;
+        uint32_t first; // Left child for inner nodes (the right child follows it), first triangle for leaves
+        glm::vec3 max;
+        uint32_t count; // Number of triangles, 0 for inner nodes
+    };
+    static_assert(sizeof(Node) == 32, "BVH nodes must stay at 32 bytes");
+
+    constexpr static uint32_t max_leaf_size = 4;
+    constexpr static int max_depth          = 48;
+
+    /**
+     * @brief Build the hierarchy of an indexed triangle list, splitting the top levels across the thread pool
+     * @param vertices Vertex positions
+     * @param indices Three indices per triangle
+     * @return Hierarchy, or nullptr if there are no triangles
+     */
+    static std::shared_ptr<TriangleMeshBVH> build(std::vector<glm::vec3> vertices, std::vector<uint32_t> indices);
+
+    /**
+     * @brief Build the hierarchy of all meshes of a model, in model space
+     */
+    static std::shared_ptr<TriangleMeshBVH> from_model(const Model &model);
+
+    /**
+     * @brief Visit every triangle whose leaf bounds overlap a box
+     * @param min Minimum corner of the box in mesh space
+     * @param max Maximum corner of the box in mesh space
+     * @param callback Called as callback(triangle_index)
+     */
+    template <typename Callback> void query(const glm::vec3 &min, const glm::vec3 &max, Callback &&callback) const {
+        uint32_t stack[max_depth + 2];
+        int size      = 0;
+        stack[size++] = 0;
+        while (size > 0) {
+            const Node &node = m_nodes[stack[--size]];
+            if (node.min.x > max.x || node.max.x < min.x || node.min.y > max.y || node.max.y < min.y ||
+                node.min.z > max.z || node.max.z < min.z)
+                continue;
+            if (node.count > 0) {
+                for (uint32_t t = node.first; t < node.first + node.count; ++t)
+                    callback(t);
+            } else {
+                stack[size++] = node.first;
+                stack[size++] = node.first + 1;
+            }
+        }
+    }
+
+    /**
+     * @brief Visit the triangles of every leaf a ray passes through, nearer leaves first
+     * @param origin Ray origin in mesh space
+     * @param direction Ray direction in mesh space, distances are measured in multiples of it
+     * @param max_distance Length of the ray
+     * @param callback Called as callback(triangle_index, max_distance), and may shorten max_distance to prune
+     */
+    template <typename Callback>
+    void raycast(const glm::vec3 &origin, const glm::vec3 &direction, float max_distance, Callback &&callback) const {
+        const glm::vec3 inverse = 1.0f / direction;
+        // Entry distance of the ray into a node, or a negative value if it misses
+        auto enter = [&](const Node &node) {
+            const glm::vec3 t0 = (node.min - origin) * inverse;
+            const glm::vec3 t1 = (node.max - origin) * inverse;
+            const glm::vec3 lo = glm::min(t0, t1), hi = glm::max(t0, t1);
+            const float t_min  = std::max(std::max(lo.x, lo.y), std::max(lo.z, 0.0f));
+            const float t_max  = std::min(std::min(hi.x, hi.y), std::min(hi.z, max_distance));
+            return t_min <= t_max ? t_min : -1.0f;
+        };
+        uint32_t stack[max_depth + 2];
+        int size      = 0;
+        stack[size++] = 0;
+        while (size > 0) {
+            // Checked again on the way out, the callback may have shortened the ray since the push
+            const Node &node = m_nodes[stack[--size]];
+            if (enter(node) < 0.0f)
+                continue;
+            if (node.count > 0) {
+                for (uint32_t t = node.first; t < node.first + node.count; ++t)
+                    callback(t, max_distance);
+                continue;
+            }
+            uint32_t near_child = node.first, far_child = node.first + 1;
+            float near_t        = enter(m_nodes[near_child]), far_t = enter(m_nodes[far_child]);
+            if (far_t >= 0.0f && (near_t < 0.0f || far_t < near_t)) {
+                std::swap(near_child, far_child);
+                std::swap(near_t, far_t);
+            }
+            // Push the farther child first so the nearer one is visited next
+            if (far_t >= 0.0f)
+                stack[size++] = far_child;
+            if (near_t >= 0.0f)
+                stack[size++] = near_child;
+        }
+    }
+
+    /**
+     * @brief Closest point on the mesh surface
+     * @param point Query point in mesh space
+     * @param max_distance Triangles further away are ignored
+     * @param closest [out] Closest surface point
+     * @param triangle [out] Triangle containing it
+     * @return false if no triangle is within max_distance
+     */
+    bool closest_point(const glm::vec3 &point, float max_distance, glm::vec3 &closest, uint32_t &triangle) const;
+
+    /**
+     * @brief Point of a triangle closest to a query point
+     */
+    static glm::vec3 closest_point_on_triangle(const glm::vec3 &point, const glm::vec3 &a, const glm::vec3 &b,
+                                               const glm::vec3 &c) noexcept;
+
+    /**
+     * @brief Two-sided ray/triangle intersection
+     * @param distance [out] Hit distance along the ray in multiples of direction
+     * @return true if the ray hits the triangle at a positive distance
+     */
+    static bool intersect_triangle(const glm::vec3 &origin, const glm::vec3 &direction, const glm::vec3 &a,
+                                   const glm::vec3 &b, const glm::vec3 &c, float &distance) noexcept;
+
+    /**
+     * @brief Corners of a triangle in mesh space
+     */
+    [[nodiscard]] std::array<glm::vec3, 3> get_triangle(uint32_t triangle) const noexcept;
+
+    [[nodiscard]] uint32_t get_triangle_count() const noexcept;
+
+    [[nodiscard]] const std::vector<Node> &get_nodes() const noexcept;
+
+    [[nodiscard]] const std::vector<glm::vec3> &get_vertices() const noexcept;
+
+    [[nodiscard]] const std::vector<uint32_t> &get_indices() const noexcept;
+
+private:
+    std::vector<glm::vec3> m_vertices;
+    std::vector<uint32_t> m_indices; // Three per triangle, in leaf order
+    std::vector<Node> m_nodes;       // Root first
+};
@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <chrono>
+#include <core/benchmark.h>
+#include <core/fwd.h>
+#include <ecs/component/groups.h>
+#include <ecs/system/physics_subsystem/collider_cache_system.h>
+#include <ecs/system/physics_subsystem/rigidbody_system.h>
+#include <numeric>
+#include <random>
+
+namespace {
+/**
+ * @brief Entities and component subsets shared by both registries
+ */
+struct Population {
+    std::vector<uint32_t> transforms;
+    std::vector<uint32_t> bodies;
+    std::vector<uint32_t> colliders;
+    std::vector<uint32_t> renderables;
+};
+
+Population make_population(size_t entity_count) {
+    std::mt19937 rng(7);
+    std::vector<uint32_t> order(entity_count);
+    std::iota(order.begin(), order.end(), 0u);
+    // Each pool receives a different shuffled subset, which is what breaks the order views rely on
+    auto subset = [&](float fraction) {
+        std::shuffle(order.begin(), order.end(), rng);
+        return std::vector<uint32_t>(order.begin(), order.begin() + static_cast<long>(fraction * entity_count));
+    };
+    Population population;
+    population.transforms  = subset(1.0f);
+    population.bodies      = subset(0.8f);
+    population.colliders   = subset(0.9f);
+    population.renderables = subset(0.6f);
+    return population;
+}
+
+void populate(entt::registry &registry, const Population &population, size_t entity_count) {
+    std::vector<entt::entity> entities(entity_count);
+    registry.create(entities.begin(), entities.end());
+    for (const auto index : population.transforms)
+        registry.emplace<Transform>(entities[index], glm::vec3(static_cast<float>(index), 0.0f, 0.0f), glm::vec3(0.0f),
+                                    glm::vec3(1.0f));
+    RigidBody body;
+    body.linear_velocity = glm::vec3(0.0f, 1.0f, 0.0f);
+    body.set_inertia_tensor(glm::mat3(0.1f)); // Solid sphere of the colliders below
+    for (const auto index : population.bodies)
+        registry.emplace<RigidBody>(entities[index], body);
+    Collider collider;
+    collider.shape  = Collider::SPHERE;
+    collider.radius = 0.5f;
+    // Caches are left to the cache system, like in a scene
+    for (const auto index : population.colliders)
+        registry.emplace<Collider>(entities[index], collider);
+    for (const auto index : population.renderables)
+        registry.emplace<Renderable>(entities[index], nullptr, Renderable::fill);
+}
+
+/**
+ * @brief Average milliseconds per step spent in each timed pass
+ */
+struct StepTimes {
+    double bodies    = 0.0;
+    double colliders = 0.0;
+    double render    = 0.0;
+    float checksum   = 0.0f; // Keeps the render pass from being optimized away
+};
+
+StepTimes time_steps(entt::registry &registry, int passes) {
+    using clock = std::chrono::high_resolution_clock;
+    auto elapsed = [](clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    };
+    constexpr float dt = 1.0f / 60.0f;
+    RigidBodySystem rigid_bodies;
+    ColliderCacheSystem collider_caches;
+    StepTimes times;
+    // The first step adds the caches, and creates the groups outside ViewLayout, so it is not timed
+    for (int pass = -1; pass < passes; ++pass) {
+        auto start = clock::now();
+        rigid_bodies.update(registry, dt);
+        const double bodies = elapsed(start);
+        // Every body moved, so every one of their colliders is refreshed
+        start = clock::now();
+        collider_caches.update(registry, dt);
+        const double colliders = elapsed(start);
+        // The traversal of RenderSystem::draw_scene, without the GL calls it makes for each entity
+        start = clock::now();
+        each_renderable(registry, [&](const Renderable &renderable, const Transform &t) {
+            times.checksum += t.world_matrix()[3][0] * static_cast<float>(renderable.mode + 1);
+        });
+        const double render = elapsed(start);
+        if (pass < 0)
+            continue;
+        times.bodies += bodies / passes;
+        times.colliders += colliders / passes;
+        times.render += render / passes;
+    }
+    return times;
+}
+} // namespace
+
+void run_layout_benchmark(size_t entity_count, int passes) {
+    const Population population = make_population(entity_count);
+    entt::registry view_registry, group_registry;
+    view_registry.ctx().emplace<ViewLayout>();
+    populate(view_registry, population, entity_count);
+    populate(group_registry, population, entity_count);
+
+    const StepTimes view  = time_steps(view_registry, passes);
+    const StepTimes group = time_steps(group_registry, passes);
+
+    get_logger()->info("[Benchmark] {} entities, milliseconds per step, views / owning groups", entity_count);
+    get_logger()->info("[Benchmark] RigidBodySystem::update: {:.3f} / {:.3f}", view.bodies, group.bodies);
+    get_logger()->info("[Benchmark] ColliderCacheSystem::update: {:.3f} / {:.3f}", view.colliders, group.colliders);
+    get_logger()->info("[Benchmark] Render traversal: {:.3f} / {:.3f}", view.render, group.render);
+    get_logger()->info("[Benchmark] Checksum {} / {}", view.checksum, group.checksum);
+}
@@ -1,12 +1,17 @@
+#include <core/benchmark.h>
 #include <core/fwd.h>
 #include <ecs/component/cloth.h>
 #include <ecs/component/collider.h>
+#include <ecs/component/prefab.h>
 #include <ecs/component/rigidbody.h>
 #include <ecs/system/input.h>
 #include <ecs/system/physics.h>
+#include <ecs/system/physics_subsystem/collider_cache_system.h>
 #include <ecs/system/physics_subsystem/collision_system.h>
 #include <ecs/system/physics_subsystem/pbd_cloth_system.h>
 #include <ecs/system/physics_subsystem/rigidbody_system.h>
+#include <ecs/system/physics_subsystem/scene_query_system.h>
+#include <ecs/system/physics_subsystem/transform_hierarchy_system.h>
 #include <ecs/system/render.h>
 #include <scene/model/model_manager.h>
 #include <scene/scene/scene.h>
@@ -18,35 +23,34 @@ void create_assets(const std::shared_ptr<Scene> &scene, entt::registry &registry
     scene->set_camera("main", std::make_shared<Camera>(camera));
     scene->set_main_camera("main");
 
-    const auto model_entity = registry.create();
-    registry.emplace<Transform>(model_entity, glm::vec3(0, 0, 0), glm::vec3(0), glm::vec3(1));
+    // Scenery made only of components a prefab describes, one instance each
+    const Prefab::Instance origin;
+
+    Prefab model;
     RigidBody model_rb;
-    model_rb.mass = 0.0f;
-    registry.emplace<RigidBody>(model_entity, model_rb);
-    Collider model_collider;
-    model_collider.shape          = Collider::CAPSULE;
-    model_collider.capsule_radius = 0.6f;
-    model_collider.capsule_height = 3.4f;
-    model_collider.offset         = glm::vec3(0.0f, 1.7f, 0.0f);
-    model_collider.visualize      = true;
-    model_collider.generate_visualize_model();
-    registry.emplace<Collider>(model_entity, model_collider);
+    model_rb.mass   = 0.0f;
+    model.rigidbody = model_rb;
     scene->load_model("marry", "assets/Marry/Marry.obj");
-    registry.emplace<Renderable>(model_entity, scene->get_model("marry"), Renderable::fill);
+    Collider model_collider;
+    model_collider.shape         = Collider::TRIANGLE_MESH;
+    model_collider.triangle_mesh = get_model_manager()->get_triangle_mesh("assets/Marry/Marry.obj");
+    model.collider               = model_collider;
+    model.renderable             = Renderable{ scene->get_model("marry"), Renderable::fill };
+    model.instantiate(registry, std::span(&origin, 1));
     scene->get_model("marry")->upload(nullptr);
 
-    const auto ground_entity = registry.create();
-    registry.emplace<Transform>(ground_entity, glm::vec3(0, 0, 0), glm::vec3(0), glm::vec3(1));
+    Prefab ground;
     scene->load_model("ground", std::string(ModelLoader::internal_prefix) + "plane1",
                       { { "width", 8.0f }, { "height", 8.0f }, { "segments_x", 1 }, { "segments_z", 1 } });
-    registry.emplace<Renderable>(ground_entity, scene->get_model("ground"));
+    ground.renderable = Renderable{ scene->get_model("ground") };
     scene->get_model("ground")->upload(nullptr);
     Collider ground_collider;
     ground_collider.shape          = Collider::BOX;
     ground_collider.half_extents   = glm::vec3(4.0f, 0.1f, 4.0f);
     ground_collider.visualize      = true;
     ground_collider.generate_visualize_model();
-    registry.emplace<Collider>(ground_entity, ground_collider);
+    ground.collider = ground_collider;
+    ground.instantiate(registry, std::span(&origin, 1));
 
     int cloth_resolution    = 32;
     const auto cloth_entity = registry.create();
@@ -70,11 +74,20 @@ void create_assets(const std::shared_ptr<Scene> &scene, entt::registry &registry
 
 void init_physics() {
     PhysicsSystem::register_subsystem<RigidBodySystem>();
+    PhysicsSystem::register_subsystem<TransformHierarchySystem>();
+    PhysicsSystem::register_subsystem<ColliderCacheSystem>();
     PhysicsSystem::register_subsystem<CollisionSystem>();
+    PhysicsSystem::register_subsystem<SceneQuerySystem>();
     PhysicsSystem::register_subsystem<PBDClothSystem>();
 }
 
-int main() {
+int main(int argc, char **argv) {
+    // Component layout benchmark, runs without a window
+    if (argc > 1 && std::string_view(argv[1]) == "--benchmark-layout") {
+        run_layout_benchmark();
+        return 0;
+    }
+
     get_window_manager()->init("test", 3840, 2160);
     init_physics();
     InputSystem::init();
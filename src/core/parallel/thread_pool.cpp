@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <core/parallel/thread_pool.h>
+
+namespace {
+thread_local bool is_pool_worker = false;
+}
+
+ThreadPool::ThreadPool(size_t num_threads) noexcept {
+    for (size_t i = 0; i < num_threads; ++i) {
+        m_workers.emplace_back(&ThreadPool::worker_thread, this);
+    }
+}
+
+ThreadPool::~ThreadPool() noexcept {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+
+    for (auto &th : m_workers) {
+        if (th.joinable()) {
+            th.join();
+        }
+    }
+    m_workers.clear();
+}
+
+size_t ThreadPool::get_thread_count() const noexcept { return m_workers.size() + 1; }
+
+size_t ThreadPool::chunk_count(size_t count, size_t min_chunk_size) const noexcept {
+    if (count == 0)
+        return 0;
+    // A few chunks per thread so that uneven chunks still balance out
+    const size_t max_chunks = get_thread_count() * 4;
+    const size_t by_size    = (count + std::max<size_t>(min_chunk_size, 1) - 1) / std::max<size_t>(min_chunk_size, 1);
+    return std::clamp<size_t>(by_size, 1, max_chunks);
+}
+
+void ThreadPool::parallel_for(size_t count, size_t min_chunk_size,
+                              const std::function<void(size_t chunk, size_t begin, size_t end)> &task) noexcept {
+    const size_t chunks = chunk_count(count, min_chunk_size);
+    if (chunks == 0)
+        return;
+    const size_t chunk_size = (count + chunks - 1) / chunks;
+
+    std::unique_lock job_lock(m_job_mutex, std::try_to_lock);
+    if (chunks == 1 || m_workers.empty() || is_pool_worker || !job_lock.owns_lock()) {
+        for (size_t c = 0; c < chunks; ++c) {
+            task(c, c * chunk_size, std::min(count, (c + 1) * chunk_size));
+        }
+        return;
+    }
+
+    auto job        = std::make_shared<Job>();
+    job->task       = &task;
+    job->count      = count;
+    job->chunk_size = chunk_size;
+    job->chunks     = chunks;
+    job->pending    = chunks;
+    {
+        std::lock_guard lock(m_mutex);
+        m_job = job;
+        ++m_generation;
+    }
+    m_cv.notify_all();
+
+    run_chunks(*job);
+
+    std::unique_lock lock(m_mutex);
+    m_done_cv.wait(lock, [&job] { return job->pending.load() == 0; });
+    m_job.reset();
+}
+
+void ThreadPool::worker_thread() noexcept {
+    is_pool_worker      = true;
+    uint64_t generation = 0;
+    while (true) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock lock(m_mutex);
+            m_cv.wait(lock, [this, generation] { return m_stop || m_generation != generation; });
+            if (m_stop) {
+                return;
+            }
+            generation = m_generation;
+            job        = m_job;
+        }
+        if (job) {
+            run_chunks(*job);
+        }
+    }
+}
+
+void ThreadPool::run_chunks(Job &job) noexcept {
+    while (true) {
+        const size_t c = job.next_chunk.fetch_add(1);
+        if (c >= job.chunks) {
+            return;
+        }
+        (*job.task)(c, c * job.chunk_size, std::min(job.count, (c + 1) * job.chunk_size));
+        if (job.pending.fetch_sub(1) == 1) {
+            std::lock_guard lock(m_mutex);
+            m_done_cv.notify_all();
+        }
+    }
+}
+
+std::shared_ptr<ThreadPool> get_thread_pool() {
+    static auto thread_pool = std::make_shared<ThreadPool>(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return thread_pool;
+}
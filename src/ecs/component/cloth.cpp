@@ -13,7 +13,7 @@ Cloth::Cloth(const std::shared_ptr<Model> &model, const Transform &transform, fl
     model->get_vertices_changed() = true;
     model->upload(nullptr);
 
-    init_transform = transform.matrix();
+    init_transform = transform.world_matrix();
 
     auto vertices = model->get_meshes()[0]->get_vertices();
     for (const auto &vertex : vertices) {
@@ -61,8 +61,8 @@ Cloth::Cloth(const std::shared_ptr<Model> &model, const Transform &transform, fl
 }
 
 void Cloth::update_model(const Transform &transform) const {
-    glm::mat4 inverse = glm::inverse(transform.matrix());
-    auto &vertices    = model->get_meshes()[0]->get_vertices();
+    const glm::mat4 &inverse = transform.world_inverse_matrix();
+    auto &vertices           = model->get_meshes()[0]->get_vertices();
     for (size_t i = 0; i < positions.size(); ++i) {
         vertices[i].position = inverse * glm::vec4(positions[i], 1.0f);
     }
@@ -1,31 +1,96 @@
 #include <ecs/component/collider.h>
+#include <ecs/component/compound_shape.h>
 #include <glm/gtx/quaternion.hpp>
 #include <scene/model/primitive_generator.h>
 
-void Collider::generate_visualize_model() {
+namespace {
+/**
+ * @brief Move the vertices of a generated model from its own frame into another one
+ */
+void place(const Model &model, const glm::mat4 &frame) {
+    const glm::mat3 rotation(frame);
+    for (const auto &mesh : model.get_meshes()) {
+        for (auto &vertex : mesh->get_vertices()) {
+            vertex.position   = glm::vec3(frame * glm::vec4(vertex.position, 1.0f));
+            vertex.normal     = rotation * vertex.normal;
+            vertex.tangent    = rotation * vertex.tangent;
+            vertex.bi_tangent = rotation * vertex.bi_tangent;
+        }
+    }
+}
+
+/**
+ * @brief Wireframe model of a collider in its own frame, not uploaded yet
+ */
+std::shared_ptr<Model> build_visualize_model(const Collider &collider) {
     std::unordered_map<std::string, std::any> params;
     std::unordered_map<std::string, std::any> color = { { "color_r", 0.0f }, { "color_g", 1.0f }, { "color_b", 0.0f } };
-    switch (shape) {
-        case SPHERE:
-            params          = { { "radius", radius }, { "material", color } };
-            visualize_model = PrimitiveGenerator::generate("sphere", params);
-            visualize_model->upload(nullptr);
-            break;
-        case BOX:
-            params          = { { "width", half_extents.x * 2.0f },
-                                { "height", half_extents.y * 2.0f },
-                                { "depth", half_extents.z * 2.0f },
-                                { "material", color } };
-            visualize_model = PrimitiveGenerator::generate("cube", params);
-            visualize_model->upload(nullptr);
-            break;
-        case CAPSULE:
-            params          = { { "height", capsule_height }, { "radius", capsule_radius }, { "material", color } };
-            visualize_model = PrimitiveGenerator::generate("capsule", params);
-            visualize_model->upload(nullptr);
-            break;
+    switch (collider.shape) {
+        case Collider::SPHERE:
+            params = { { "radius", collider.radius }, { "material", color } };
+            return PrimitiveGenerator::generate("sphere", params);
+        case Collider::BOX:
+            params = { { "width", collider.half_extents.x * 2.0f },
+                       { "height", collider.half_extents.y * 2.0f },
+                       { "depth", collider.half_extents.z * 2.0f },
+                       { "material", color } };
+            return PrimitiveGenerator::generate("cube", params);
+        case Collider::CAPSULE:
+            params = { { "height", collider.capsule_height },
+                       { "radius", collider.capsule_radius },
+                       { "material", color } };
+            return PrimitiveGenerator::generate("capsule", params);
+        case Collider::CONVEX_HULL:
+            params = { { "hull", collider.convex_hull }, { "material", color } };
+            return PrimitiveGenerator::generate("convex_hull", params);
+        case Collider::TRIANGLE_MESH:
+            params = { { "mesh", collider.triangle_mesh }, { "material", color } };
+            return PrimitiveGenerator::generate("triangle_mesh", params);
+        case Collider::SDF: {
+            // The field does not keep its source mesh, its bounds show where it is sampled
+            if (!collider.signed_distance_field)
+                return nullptr;
+            const glm::vec3 min = collider.signed_distance_field->get_bounds_min();
+            const glm::vec3 max = collider.signed_distance_field->get_bounds_max();
+            params              = { { "width", max.x - min.x },
+                                    { "height", max.y - min.y },
+                                    { "depth", max.z - min.z },
+                                    { "material", color } };
+            auto model          = PrimitiveGenerator::generate("cube", params);
+            if (model)
+                place(*model, glm::translate(glm::mat4(1.0f), (min + max) * 0.5f));
+            return model;
+        }
+        case Collider::PLANE:
+            // A finite patch of the infinite plane
+            params = { { "width", 20.0f }, { "height", 20.0f }, { "material", color } };
+            return PrimitiveGenerator::generate("plane", params);
+        case Collider::HEIGHTFIELD:
+            params = { { "field", collider.height_field }, { "material", color } };
+            return PrimitiveGenerator::generate("height_field", params);
+        case Collider::COMPOUND: {
+            // One model per child placed in the collider frame, drawn together as the meshes of a single model
+            if (!collider.compound)
+                return nullptr;
+            std::vector<std::shared_ptr<Mesh>> meshes;
+            for (const auto &child : collider.compound->get_children()) {
+                const auto model = build_visualize_model(child.collider);
+                if (!model)
+                    continue;
+                place(*model, glm::translate(glm::mat4(1.0f), child.position) * glm::toMat4(child.rotation));
+                meshes.insert(meshes.end(), model->get_meshes().begin(), model->get_meshes().end());
+            }
+            return std::make_shared<Model>("internal://primitive/compound", std::move(meshes));
+        }
         default:
             get_logger()->error("Unsupported collider shape");
-            break;
+            return nullptr;
     }
 }
+} // namespace
+
+void Collider::generate_visualize_model() {
+    visualize_model = build_visualize_model(*this);
+    if (visualize_model)
+        visualize_model->upload(nullptr);
+}
@@ -0,0 +1,113 @@
+#include <ecs/component/collider.h>
+#include <ecs/component/collider_cache.h>
+#include <ecs/component/compound_shape.h>
+#include <ecs/component/transform.h>
+#include <glm/ext/matrix_transform.hpp>
+
+namespace {
+/**
+ * @brief Fill in everything derived from the cached matrices: center, basis, capsule ends and bounds
+ */
+void update_shape(const Collider &c, ColliderCache &cache) {
+    cache.center         = glm::vec3(cache.matrix[3]);
+    const glm::mat3 linear(cache.matrix);
+    cache.basis = glm::mat3(glm::normalize(linear[0]), glm::normalize(linear[1]), glm::normalize(linear[2]));
+    switch (c.shape) {
+        case Collider::SPHERE:
+            cache.aabb.min = cache.center - glm::vec3(c.radius);
+            cache.aabb.max = cache.center + glm::vec3(c.radius);
+            break;
+        case Collider::BOX: {
+            // Project the oriented box onto the world axes
+            glm::vec3 extent(0.0f);
+            for (int i = 0; i < 3; ++i) {
+                extent += glm::abs(linear[i]) * c.half_extents[i];
+            }
+            cache.aabb.min = cache.center - extent;
+            cache.aabb.max = cache.center + extent;
+            break;
+        }
+        case Collider::CAPSULE: {
+            // Cylinder part of the capsule (total height - 2 * radius) along the local up axis
+            const float half_cylinder = glm::max(c.capsule_height - 2 * c.capsule_radius, 0.0f) * 0.5f;
+            cache.capsule_base        = cache.center - cache.basis[1] * half_cylinder;
+            cache.capsule_top         = cache.center + cache.basis[1] * half_cylinder;
+            cache.aabb.min = glm::min(cache.capsule_base, cache.capsule_top) - glm::vec3(c.capsule_radius);
+            cache.aabb.max = glm::max(cache.capsule_base, cache.capsule_top) + glm::vec3(c.capsule_radius);
+            break;
+        }
+        case Collider::CONVEX_HULL: {
+            if (!c.convex_hull) {
+                cache.aabb.min = cache.aabb.max = cache.center;
+                break;
+            }
+            // Extreme vertices along the world axes, searched in hull space
+            const glm::mat3 to_local = glm::transpose(linear);
+            const auto &vertices     = c.convex_hull->get_vertices();
+            uint32_t hint            = 0;
+            for (int axis = 0; axis < 3; ++axis) {
+                hint                 = c.convex_hull->support(-to_local[axis], hint);
+                cache.aabb.min[axis] = glm::vec3(cache.matrix * glm::vec4(vertices[hint], 1.0f))[axis];
+                hint                 = c.convex_hull->support(to_local[axis], hint);
+                cache.aabb.max[axis] = glm::vec3(cache.matrix * glm::vec4(vertices[hint], 1.0f))[axis];
+            }
+            break;
+        }
+        case Collider::TRIANGLE_MESH: {
+            if (!c.triangle_mesh) {
+                cache.aabb.min = cache.aabb.max = cache.center;
+                break;
+            }
+            const auto &root = c.triangle_mesh->get_nodes().front();
+            cache.aabb       = AABB{ root.min, root.max }.transformed(cache.matrix);
+            break;
+        }
+        case Collider::SDF: {
+            if (!c.signed_distance_field) {
+                cache.aabb.min = cache.aabb.max = cache.center;
+                break;
+            }
+            const auto &field = *c.signed_distance_field;
+            cache.aabb        = AABB{ field.get_bounds_min(), field.get_bounds_max() }.transformed(cache.matrix);
+            break;
+        }
+        case Collider::PLANE:
+            // Unbounded, planes are paired outside the broadphase
+            cache.aabb.min = glm::vec3(-FLT_MAX);
+            cache.aabb.max = glm::vec3(FLT_MAX);
+            break;
+        case Collider::HEIGHTFIELD: {
+            if (!c.height_field) {
+                cache.aabb.min = cache.aabb.max = cache.center;
+                break;
+            }
+            const auto &field = *c.height_field;
+            cache.aabb        = AABB{ field.get_bounds_min(), field.get_bounds_max() }.transformed(cache.matrix);
+            break;
+        }
+        case Collider::COMPOUND:
+            // One box around all children, the broadphase never sees them separately
+            if (!c.compound || c.compound->get_children().empty()) {
+                cache.aabb.min = cache.aabb.max = cache.center;
+                break;
+            }
+            cache.aabb = c.compound->get_bounds().transformed(cache.matrix);
+            break;
+    }
+}
+} // namespace
+
+void ColliderCache::refresh(const Transform &t, const Collider &c) {
+    // Both matrices come from the transform cache, the offset is a pure translation in the entity frame
+    matrix         = glm::translate(t.world_matrix(), c.offset);
+    inverse_matrix = glm::translate(glm::mat4(1.0f), -c.offset) * t.world_inverse_matrix();
+    update_shape(c, *this);
+    transform_version = t.get_world_version();
+    collider_version  = c.version;
+}
+
+void ColliderCache::refresh(const glm::mat4 &frame, const Collider &c) {
+    matrix         = frame;
+    inverse_matrix = glm::inverse(matrix);
+    update_shape(c, *this);
+}
@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <core/fwd.h>
+#include <ecs/component/compound_shape.h>
+#include <glm/ext/matrix_transform.hpp>
+
+void CompoundShape::add_child(const Collider &collider, const glm::vec3 &position, const glm::quat &rotation) {
+    // Unbounded and nested shapes would defeat the tree
+    if (collider.shape == Collider::COMPOUND || collider.shape == Collider::PLANE) {
+        get_logger()->error("[CompoundShape] Compound children cannot be compounds or planes");
+        return;
+    }
+    m_children.push_back({ collider, position, glm::normalize(rotation) });
+    m_children.back().collider.offset = glm::vec3(0.0f);
+}
+
+void CompoundShape::build() {
+    m_matrices.clear();
+    m_child_bounds.clear();
+    m_nodes.clear();
+    if (m_children.empty())
+        return;
+    ColliderCache cache;
+    for (const auto &child : m_children) {
+        m_matrices.push_back(glm::translate(glm::mat4(1.0f), child.position) * glm::mat4_cast(child.rotation));
+        cache.refresh(m_matrices.back(), child.collider);
+        m_child_bounds.push_back(cache.aabb);
+    }
+    std::vector<uint32_t> order(m_children.size());
+    for (uint32_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    m_nodes.reserve(2 * m_children.size() - 1);
+    m_nodes.resize(1);
+    build_node(order, 0, 0, static_cast<uint32_t>(order.size()));
+}
+
+void CompoundShape::build_node(std::vector<uint32_t> &order, uint32_t node, uint32_t begin, uint32_t end) {
+    AABB bounds, centers;
+    for (uint32_t i = begin; i < end; ++i) {
+        bounds                 = AABB::merge(bounds, m_child_bounds[order[i]]);
+        const glm::vec3 center = m_child_bounds[order[i]].center();
+        centers                = AABB::merge(centers, { center, center });
+    }
+    if (end - begin == 1) {
+        m_nodes[node] = { bounds, order[begin], 1 };
+        return;
+    }
+
+    // Median split along the widest spread of child centers, which keeps the tree balanced
+    const glm::vec3 spread = centers.max - centers.min;
+    const int axis         = spread.x >= spread.y && spread.x >= spread.z ? 0 : (spread.y >= spread.z ? 1 : 2);
+    const uint32_t middle  = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end, [&](uint32_t a, uint32_t b) {
+        return m_child_bounds[a].center()[axis] < m_child_bounds[b].center()[axis];
+    });
+    const auto left = static_cast<uint32_t>(m_nodes.size());
+    m_nodes[node]   = { bounds, left, 0 };
+    m_nodes.resize(m_nodes.size() + 2);
+    build_node(order, left, begin, middle);
+    build_node(order, left + 1, middle, end);
+}
+
+void CompoundShape::child_cache(const ColliderCache &compound, uint32_t child, ColliderCache &cache) const {
+    cache.refresh(compound.matrix * m_matrices[child], m_children[child].collider);
+}
+
+const std::vector<CompoundShape::Child> &CompoundShape::get_children() const noexcept { return m_children; }
+
+AABB CompoundShape::get_bounds() const noexcept { return m_nodes.empty() ? AABB{} : m_nodes.front().bounds; }
@@ -0,0 +1,50 @@
+#include <ecs/component/collider_cache.h>
+#include <ecs/component/prefab.h>
+
+namespace {
+/**
+ * @brief Grow a pool once for a whole batch instead of letting every insert reallocate it
+ */
+template <typename T> void reserve(entt::registry &registry, size_t count) {
+    auto &storage = registry.storage<T>();
+    storage.reserve(storage.size() + count);
+}
+} // namespace
+
+std::vector<entt::entity> Prefab::instantiate(entt::registry &registry, std::span<const Instance> instances) const {
+    std::vector<entt::entity> entities(instances.size());
+    if (instances.empty())
+        return entities;
+    registry.create(entities.begin(), entities.end());
+
+    std::vector<Transform> transforms;
+    transforms.reserve(instances.size());
+    for (const auto &instance : instances)
+        transforms.emplace_back(instance.position, instance.rotation, scale);
+    reserve<Transform>(registry, entities.size());
+    registry.insert<Transform>(entities.begin(), entities.end(), transforms.begin());
+
+    if (rigidbody) {
+        std::vector<RigidBody> bodies(instances.size(), *rigidbody);
+        for (size_t i = 0; i < instances.size(); ++i) {
+            bodies[i].linear_velocity   = instances[i].linear_velocity;
+            bodies[i].angular_velocity  = instances[i].angular_velocity;
+            bodies[i].previous_position = instances[i].position;
+        }
+        reserve<RigidBody>(registry, entities.size());
+        registry.insert<RigidBody>(entities.begin(), entities.end(), bodies.begin());
+    }
+    if (renderable) {
+        reserve<Renderable>(registry, entities.size());
+        registry.insert<Renderable>(entities.begin(), entities.end(), *renderable);
+    }
+    if (collider) {
+        reserve<Collider>(registry, entities.size());
+        registry.insert<Collider>(entities.begin(), entities.end(), *collider);
+        // Empty caches join the collider group in one block. Their versions never match, so the cache system fills
+        // them in its parallel pass before the next collision step
+        reserve<ColliderCache>(registry, entities.size());
+        registry.insert<ColliderCache>(entities.begin(), entities.end());
+    }
+    return entities;
+}
@@ -19,7 +19,7 @@ void RigidBody::update_inertia() {
 }
 
 void RigidBody::integrate(float dt, const glm::vec3 &gravity) {
-    if (is_kinematic || mass <= 0.0f)
+    if (is_kinematic || is_sleeping || mass <= 0.0f)
         return;
 
     // Apply gravity
@@ -46,11 +46,41 @@ void RigidBody::integrate(float dt, const glm::vec3 &gravity) {
     torque_accumulator = glm::vec3(0);
 }
 
-void RigidBody::add_force(const glm::vec3 &force) { force_accumulator += force; }
+bool RigidBody::update_sleep_timer(float dt) {
+    if (!can_sleep || glm::dot(linear_velocity, linear_velocity) > sleep_linear_velocity * sleep_linear_velocity ||
+        glm::dot(angular_velocity, angular_velocity) > sleep_angular_velocity * sleep_angular_velocity) {
+        sleep_timer = 0.0f;
+        return false;
+    }
+    sleep_timer += dt;
+    return sleep_timer >= time_to_sleep;
+}
+
+void RigidBody::sleep() {
+    is_sleeping        = true;
+    linear_velocity    = glm::vec3(0);
+    angular_velocity   = glm::vec3(0);
+    force_accumulator  = glm::vec3(0);
+    torque_accumulator = glm::vec3(0);
+}
+
+void RigidBody::wake_up() {
+    is_sleeping = false;
+    sleep_timer = 0.0f;
+}
+
+void RigidBody::add_force(const glm::vec3 &force) {
+    force_accumulator += force;
+    wake_up();
+}
 
 void RigidBody::add_force_at_position(const glm::vec3 &force, const glm::vec3 &position) {
     force_accumulator += force;
     torque_accumulator += glm::cross(position - center_of_mass, force);
+    wake_up();
 }
 
-void RigidBody::add_torque(const glm::vec3 &torque) { torque_accumulator += torque; }
+void RigidBody::add_torque(const glm::vec3 &torque) {
+    torque_accumulator += torque;
+    wake_up();
+}
@@ -4,8 +4,61 @@
 Transform::Transform(const glm::vec3 &pos, const glm::vec3 &rot, const glm::vec3 &scl)
     : position(pos), rotation(rot), scale(scl) {}
 
-glm::quat Transform::orientation() const { return { rotation }; }
+Transform::Transform(const glm::vec3 &pos, const glm::quat &rot, const glm::vec3 &scl)
+    : position(pos), rotation(rot), scale(scl) {}
+
+const glm::quat &Transform::orientation() const { return rotation; }
+
+glm::vec3 Transform::euler_angles() const { return glm::eulerAngles(rotation); }
+
+void Transform::set_euler_angles(const glm::vec3 &angles) { rotation = glm::quat(angles); }
+
+const glm::mat4 &Transform::matrix() const {
+    update_matrices();
+    return m_matrix;
+}
+
+const glm::mat4 &Transform::inverse_matrix() const {
+    update_matrices();
+    return m_inverse_matrix;
+}
+
+const glm::mat4 &Transform::world_matrix() const { return parent == entt::null ? matrix() : m_world_matrix; }
+
+const glm::mat4 &Transform::world_inverse_matrix() const {
+    return parent == entt::null ? inverse_matrix() : m_world_inverse_matrix;
+}
+
+uint32_t Transform::get_version() const {
+    update_matrices();
+    return m_version;
+}
+
+uint32_t Transform::get_world_version() const {
+    // Both counters only grow, so their sum changes whenever either does
+    return get_version() + m_world_changes;
+}
 
-glm::mat4 Transform::matrix() const {
-    return glm::translate(glm::mat4(1.0f), position) * glm::toMat4(orientation()) * glm::scale(glm::mat4(1.0f), scale);
-}
\ No newline at end of file
+void Transform::update_matrices() const {
+    // The parent is part of the snapshot so relinking counts as a change, although the local matrices stay the same
+    if (position == m_built_position && rotation == m_built_rotation && scale == m_built_scale &&
+        parent == m_built_parent)
+        return;
+    const glm::mat3 basis = glm::toMat3(rotation);
+    m_matrix              = glm::mat4(basis);
+    for (int i = 0; i < 3; ++i)
+        m_matrix[i] *= scale[i];
+    m_matrix[3] = glm::vec4(position, 1.0f);
+    // Inverse of T * R * S is S^-1 * R^T * T^-1, with no general 4x4 inversion
+    const glm::vec3 inverse_scale = 1.0f / scale;
+    glm::mat3 inverse_linear      = glm::transpose(basis);
+    for (int i = 0; i < 3; ++i)
+        inverse_linear[i] *= inverse_scale;
+    m_inverse_matrix    = glm::mat4(inverse_linear);
+    m_inverse_matrix[3] = glm::vec4(-(inverse_linear * position), 1.0f);
+    m_built_position    = position;
+    m_built_rotation    = rotation;
+    m_built_scale       = scale;
+    m_built_parent      = parent;
+    ++m_version;
+}
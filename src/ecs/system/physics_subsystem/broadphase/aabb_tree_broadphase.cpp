@@ -0,0 +1,87 @@
+#include <ecs/system/physics_subsystem/broadphase/aabb_tree_broadphase.h>
+
+void AabbTreeBroadphase::update(const std::vector<BroadphaseProxy> &proxies) {
+    ++m_stamp;
+    for (const auto &proxy : proxies) {
+        auto it = m_lookup.find(proxy.entity);
+        if (it == m_lookup.end()) {
+            int index;
+            if (m_free_records.empty()) {
+                index = static_cast<int>(m_records.size());
+                m_records.emplace_back();
+            } else {
+                index = m_free_records.back();
+                m_free_records.pop_back();
+            }
+            m_records[index] = { proxy, DynamicAabbTree::null_node, m_stamp };
+            m_lookup.emplace(proxy.entity, index);
+            insert(index);
+            continue;
+        }
+        auto &record = m_records[it->second];
+        record.stamp = m_stamp;
+        if (record.proxy.is_static != proxy.is_static) {
+            // Body switched between static and dynamic, move it to the other tree
+            remove(it->second);
+            record.proxy = proxy;
+            insert(it->second);
+            continue;
+        }
+        // Static and sleeping proxies do not move, most moving ones stay inside their fat box: none of them
+        // touches the tree
+        if (!record.fat.contains(proxy.aabb)) {
+            auto &tree = record.proxy.is_static ? m_static_tree : m_dynamic_tree;
+            tree.move_proxy(record.node, proxy.aabb, proxy.aabb.center() - record.proxy.aabb.center());
+            record.fat = tree.get_fat_aabb(record.node);
+        }
+        // Filter bits may have changed as well
+        record.proxy = proxy;
+    }
+    // Drop colliders that were destroyed or deactivated
+    for (auto it = m_lookup.begin(); it != m_lookup.end();) {
+        if (m_records[it->second].stamp != m_stamp) {
+            remove(it->second);
+            m_records[it->second].proxy.entity = entt::null;
+            m_free_records.push_back(it->second);
+            it = m_lookup.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void AabbTreeBroadphase::find_pairs(std::vector<BroadphasePair> &pairs) {
+    for (int i = 0; i < static_cast<int>(m_records.size()); ++i) {
+        const auto &proxy = m_records[i].proxy;
+        if (proxy.entity == entt::null || proxy.is_static)
+            continue;
+        // Dynamic vs dynamic, reported by the proxy with the lower index only
+        m_dynamic_tree.query(proxy.aabb, [&](int node) {
+            const int other = m_dynamic_tree.get_user_data(node);
+            const auto &b   = m_records[other].proxy;
+            if (other > i && can_pair(proxy, b) && proxy.aabb.overlaps(b.aabb))
+                pairs.push_back({ proxy.entity, b.entity });
+            return true;
+        });
+        // Dynamic vs static, static proxies never query
+        m_static_tree.query(proxy.aabb, [&](int node) {
+            const auto &b = m_records[m_static_tree.get_user_data(node)].proxy;
+            if (can_pair(proxy, b) && proxy.aabb.overlaps(b.aabb))
+                pairs.push_back({ proxy.entity, b.entity });
+            return true;
+        });
+    }
+}
+
+void AabbTreeBroadphase::insert(int record) {
+    auto &r    = m_records[record];
+    auto &tree = r.proxy.is_static ? m_static_tree : m_dynamic_tree;
+    r.node     = tree.create_proxy(r.proxy.aabb, record);
+    r.fat      = tree.get_fat_aabb(r.node);
+}
+
+void AabbTreeBroadphase::remove(int record) {
+    auto &r = m_records[record];
+    (r.proxy.is_static ? m_static_tree : m_dynamic_tree).destroy_proxy(r.node);
+    r.node = DynamicAabbTree::null_node;
+}
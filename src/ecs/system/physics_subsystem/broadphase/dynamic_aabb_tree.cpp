@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <cstdlib>
+#include <ecs/system/physics_subsystem/broadphase/dynamic_aabb_tree.h>
+
+DynamicAabbTree::DynamicAabbTree(float margin) : m_margin(margin) {}
+
+int DynamicAabbTree::create_proxy(const AABB &aabb, int user_data) {
+    const int proxy           = allocate_node();
+    m_nodes[proxy].aabb       = { aabb.min - glm::vec3(m_margin), aabb.max + glm::vec3(m_margin) };
+    m_nodes[proxy].user_data  = user_data;
+    m_nodes[proxy].height     = 0;
+    insert_leaf(proxy);
+    return proxy;
+}
+
+void DynamicAabbTree::destroy_proxy(int proxy) {
+    remove_leaf(proxy);
+    free_node(proxy);
+}
+
+bool DynamicAabbTree::move_proxy(int proxy, const AABB &aabb, const glm::vec3 &displacement) {
+    if (m_nodes[proxy].aabb.contains(aabb))
+        return false;
+    remove_leaf(proxy);
+    // Extend the fat box along the direction of motion to anticipate the next steps
+    AABB fat{ aabb.min - glm::vec3(m_margin), aabb.max + glm::vec3(m_margin) };
+    const glm::vec3 d = displacement * displacement_multiplier;
+    for (int i = 0; i < 3; ++i) {
+        if (d[i] < 0.0f)
+            fat.min[i] += d[i];
+        else
+            fat.max[i] += d[i];
+    }
+    m_nodes[proxy].aabb = fat;
+    insert_leaf(proxy);
+    return true;
+}
+
+int DynamicAabbTree::allocate_node() {
+    if (m_free_list == null_node) {
+        m_nodes.emplace_back();
+        return static_cast<int>(m_nodes.size()) - 1;
+    }
+    const int node = m_free_list;
+    m_free_list    = m_nodes[node].parent;
+    m_nodes[node]  = Node{};
+    return node;
+}
+
+void DynamicAabbTree::free_node(int node) {
+    m_nodes[node].parent = m_free_list;
+    m_nodes[node].height = -1;
+    m_free_list          = node;
+}
+
+void DynamicAabbTree::insert_leaf(int leaf) {
+    if (m_root == null_node) {
+        m_root                = leaf;
+        m_nodes[leaf].parent = null_node;
+        return;
+    }
+    // Descend towards the sibling with the smallest surface area heuristic cost
+    const AABB leaf_aabb = m_nodes[leaf].aabb;
+    int index            = m_root;
+    while (!m_nodes[index].is_leaf()) {
+        const int child1     = m_nodes[index].child1;
+        const int child2     = m_nodes[index].child2;
+        const float area     = m_nodes[index].aabb.surface_area();
+        const float combined = AABB::merge(m_nodes[index].aabb, leaf_aabb).surface_area();
+        // Cost of creating a new parent for this node and the leaf
+        const float cost = 2.0f * combined;
+        // Minimum cost of pushing the leaf further down the tree
+        const float inheritance_cost = 2.0f * (combined - area);
+        auto descend_cost            = [&](int child) {
+            const float merged_area = AABB::merge(leaf_aabb, m_nodes[child].aabb).surface_area();
+            if (m_nodes[child].is_leaf())
+                return merged_area + inheritance_cost;
+            return merged_area - m_nodes[child].aabb.surface_area() + inheritance_cost;
+        };
+        const float cost1 = descend_cost(child1);
+        const float cost2 = descend_cost(child2);
+        if (cost < cost1 && cost < cost2)
+            break;
+        index = cost1 < cost2 ? child1 : child2;
+    }
+    // Create a new parent joining the sibling and the leaf
+    const int sibling    = index;
+    const int old_parent = m_nodes[sibling].parent;
+    const int new_parent = allocate_node();
+    m_nodes[new_parent].parent = old_parent;
+    m_nodes[new_parent].aabb   = AABB::merge(leaf_aabb, m_nodes[sibling].aabb);
+    m_nodes[new_parent].height = m_nodes[sibling].height + 1;
+    m_nodes[new_parent].child1 = sibling;
+    m_nodes[new_parent].child2 = leaf;
+    m_nodes[sibling].parent    = new_parent;
+    m_nodes[leaf].parent       = new_parent;
+    if (old_parent != null_node) {
+        if (m_nodes[old_parent].child1 == sibling)
+            m_nodes[old_parent].child1 = new_parent;
+        else
+            m_nodes[old_parent].child2 = new_parent;
+    } else {
+        m_root = new_parent;
+    }
+    // Refit and rebalance the ancestors
+    index = m_nodes[leaf].parent;
+    while (index != null_node) {
+        index               = balance(index);
+        const int child1    = m_nodes[index].child1;
+        const int child2    = m_nodes[index].child2;
+        m_nodes[index].height = 1 + std::max(m_nodes[child1].height, m_nodes[child2].height);
+        m_nodes[index].aabb   = AABB::merge(m_nodes[child1].aabb, m_nodes[child2].aabb);
+        index                 = m_nodes[index].parent;
+    }
+}
+
+void DynamicAabbTree::remove_leaf(int leaf) {
+    if (leaf == m_root) {
+        m_root = null_node;
+        return;
+    }
+    const int parent       = m_nodes[leaf].parent;
+    const int grand_parent = m_nodes[parent].parent;
+    const int sibling      = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+    if (grand_parent == null_node) {
+        m_root                  = sibling;
+        m_nodes[sibling].parent = null_node;
+        free_node(parent);
+        return;
+    }
+    // Replace the parent by the sibling and refit upwards
+    if (m_nodes[grand_parent].child1 == parent)
+        m_nodes[grand_parent].child1 = sibling;
+    else
+        m_nodes[grand_parent].child2 = sibling;
+    m_nodes[sibling].parent = grand_parent;
+    free_node(parent);
+    int index = grand_parent;
+    while (index != null_node) {
+        index               = balance(index);
+        const int child1    = m_nodes[index].child1;
+        const int child2    = m_nodes[index].child2;
+        m_nodes[index].aabb   = AABB::merge(m_nodes[child1].aabb, m_nodes[child2].aabb);
+        m_nodes[index].height = 1 + std::max(m_nodes[child1].height, m_nodes[child2].height);
+        index                 = m_nodes[index].parent;
+    }
+}
+
+int DynamicAabbTree::balance(int a) {
+    // Rotate the taller grandchild up when the subtree heights differ by more than one
+    Node &node_a = m_nodes[a];
+    if (node_a.is_leaf() || node_a.height < 2)
+        return a;
+    const int b     = node_a.child1;
+    const int c     = node_a.child2;
+    const int delta = m_nodes[c].height - m_nodes[b].height;
+    if (delta == 0 || std::abs(delta) == 1)
+        return a;
+    // The taller child is promoted to the position of a
+    const int up    = delta > 0 ? c : b;
+    const int other = delta > 0 ? b : c;
+    const int f     = m_nodes[up].child1;
+    const int g     = m_nodes[up].child2;
+    m_nodes[up].child1 = a;
+    m_nodes[up].parent = node_a.parent;
+    node_a.parent      = up;
+    if (m_nodes[up].parent != null_node) {
+        if (m_nodes[m_nodes[up].parent].child1 == a)
+            m_nodes[m_nodes[up].parent].child1 = up;
+        else
+            m_nodes[m_nodes[up].parent].child2 = up;
+    } else {
+        m_root = up;
+    }
+    // The taller grandchild stays under the promoted node, the shorter one replaces it under a
+    const int keep = m_nodes[f].height > m_nodes[g].height ? f : g;
+    const int move = keep == f ? g : f;
+    m_nodes[up].child2   = keep;
+    m_nodes[move].parent = a;
+    if (delta > 0)
+        node_a.child2 = move;
+    else
+        node_a.child1 = move;
+    node_a.aabb        = AABB::merge(m_nodes[other].aabb, m_nodes[move].aabb);
+    node_a.height      = 1 + std::max(m_nodes[other].height, m_nodes[move].height);
+    m_nodes[up].aabb   = AABB::merge(node_a.aabb, m_nodes[keep].aabb);
+    m_nodes[up].height = 1 + std::max(node_a.height, m_nodes[keep].height);
+    return up;
+}
@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <ecs/system/physics_subsystem/broadphase/sweep_and_prune.h>
+
+void SweepAndPrune::update(const std::vector<BroadphaseProxy> &proxies) {
+    m_lookup.clear();
+    for (size_t i = 0; i < proxies.size(); ++i) {
+        m_lookup.emplace(proxies[i].entity, i);
+    }
+    m_seen.assign(proxies.size(), false);
+    // Refresh bounds in place and drop proxies that disappeared, keeping the previous order
+    size_t write = 0;
+    for (auto &proxy : m_sorted) {
+        auto it = m_lookup.find(proxy.entity);
+        if (it == m_lookup.end())
+            continue;
+        m_seen[it->second] = true;
+        m_sorted[write++]  = proxies[it->second];
+    }
+    m_sorted.resize(write);
+    // Newly created colliders are appended and merged in by the sort
+    for (size_t i = 0; i < proxies.size(); ++i) {
+        if (!m_seen[i])
+            m_sorted.push_back(proxies[i]);
+    }
+    sort(write);
+}
+
+void SweepAndPrune::sort(size_t kept) {
+    const int axis = m_axis;
+    auto less      = [axis](const BroadphaseProxy &a, const BroadphaseProxy &b) {
+        return a.aabb.min[axis] < b.aabb.min[axis];
+    };
+    // A changed axis invalidates the temporal coherence, fall back to a full sort
+    if (axis != m_sort_axis) {
+        std::sort(m_sorted.begin(), m_sorted.end(), less);
+        m_sort_axis = axis;
+        return;
+    }
+    for (size_t i = 1; i < kept; ++i) {
+        if (!less(m_sorted[i], m_sorted[i - 1]))
+            continue;
+        BroadphaseProxy key = m_sorted[i];
+        size_t j           = i;
+        while (j > 0 && less(key, m_sorted[j - 1])) {
+            m_sorted[j] = m_sorted[j - 1];
+            --j;
+        }
+        m_sorted[j] = key;
+    }
+    // Sorting new proxies in place would be quadratic when many are spawned at once, they are sorted on their own
+    // and merged instead
+    if (kept < m_sorted.size()) {
+        std::sort(m_sorted.begin() + kept, m_sorted.end(), less);
+        std::inplace_merge(m_sorted.begin(), m_sorted.begin() + kept, m_sorted.end(), less);
+    }
+}
+
+void SweepAndPrune::find_pairs(std::vector<BroadphasePair> &pairs) {
+    const int axis = m_axis;
+    glm::vec3 sum(0.0f), sum_sq(0.0f);
+    for (size_t i = 0; i < m_sorted.size(); ++i) {
+        const auto &a = m_sorted[i];
+        // Accumulate center statistics to pick next step's sweep axis
+        const glm::vec3 center = a.aabb.center();
+        sum += center;
+        sum_sq += center * center;
+        // Only proxies starting before this one ends on the sweep axis can overlap it
+        const float max_a = a.aabb.max[axis];
+        for (size_t j = i + 1; j < m_sorted.size() && m_sorted[j].aabb.min[axis] <= max_a; ++j) {
+            if (can_pair(a, m_sorted[j]) && a.aabb.overlaps(m_sorted[j].aabb))
+                pairs.push_back({ a.entity, m_sorted[j].entity });
+        }
+    }
+    if (m_sorted.empty())
+        return;
+    const float inv_count    = 1.0f / static_cast<float>(m_sorted.size());
+    const glm::vec3 mean     = sum * inv_count;
+    const glm::vec3 variance = sum_sq * inv_count - mean * mean;
+    m_axis                   = 0;
+    if (variance.y > variance[m_axis])
+        m_axis = 1;
+    if (variance.z > variance[m_axis])
+        m_axis = 2;
+}
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <cmath>
+#include <core/parallel/thread_pool.h>
+#include <ecs/system/physics_subsystem/broadphase/uniform_grid.h>
+
+UniformGridBroadphase::UniformGridBroadphase(float cell_size) : m_cell_size(cell_size) {}
+
+void UniformGridBroadphase::update(const std::vector<BroadphaseProxy> &proxies) {
+    m_proxies = proxies;
+    if (m_cell_size > 0.0f) {
+        m_current_cell_size = m_cell_size;
+    } else if (!m_proxies.empty()) {
+        // Cells about as large as the typical body, so most proxies touch at most eight cells
+        float total = 0.0f;
+        for (const auto &proxy : m_proxies) {
+            const glm::vec3 size = proxy.aabb.max - proxy.aabb.min;
+            total += std::max(size.x, std::max(size.y, size.z));
+        }
+        m_current_cell_size = std::max(total / static_cast<float>(m_proxies.size()), 1e-3f);
+    }
+    build_entries();
+    radix_sort();
+}
+
+glm::ivec3 UniformGridBroadphase::cell_of(const glm::vec3 &point) const {
+    return { static_cast<int>(std::floor(point.x / m_current_cell_size)),
+             static_cast<int>(std::floor(point.y / m_current_cell_size)),
+             static_cast<int>(std::floor(point.z / m_current_cell_size)) };
+}
+
+uint64_t UniformGridBroadphase::cell_key(const glm::ivec3 &cell) {
+    // 21 bits per axis around a bias, enough for two million cells in every direction
+    constexpr uint64_t bias = 1u << 20;
+    constexpr uint64_t mask = (1u << 21) - 1;
+    return ((static_cast<uint64_t>(cell.x) + bias) & mask) << 42 | ((static_cast<uint64_t>(cell.y) + bias) & mask) << 21 |
+           ((static_cast<uint64_t>(cell.z) + bias) & mask);
+}
+
+void UniformGridBroadphase::build_entries() {
+    const size_t count = m_proxies.size();
+    m_entry_offsets.assign(count + 1, 0);
+    m_large_proxies.clear();
+    // Count the cells covered by each proxy
+    get_thread_pool()->parallel_for(count, 256, [this](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const glm::ivec3 lo     = cell_of(m_proxies[i].aabb.min);
+            const glm::ivec3 hi     = cell_of(m_proxies[i].aabb.max);
+            const glm::ivec3 extent = hi - lo + glm::ivec3(1);
+            const size_t cells =
+                static_cast<size_t>(extent.x) * static_cast<size_t>(extent.y) * static_cast<size_t>(extent.z);
+            m_entry_offsets[i + 1] = cells > max_cells_per_proxy ? 0 : cells;
+        }
+    });
+    for (size_t i = 0; i < count; ++i) {
+        if (m_entry_offsets[i + 1] == 0)
+            m_large_proxies.push_back(static_cast<uint32_t>(i));
+        m_entry_offsets[i + 1] += m_entry_offsets[i];
+    }
+    // Each proxy writes its entries into its own slice
+    m_entries.resize(m_entry_offsets[count]);
+    get_thread_pool()->parallel_for(count, 256, [this](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            size_t out = m_entry_offsets[i];
+            if (out == m_entry_offsets[i + 1])
+                continue;
+            const glm::ivec3 lo = cell_of(m_proxies[i].aabb.min);
+            const glm::ivec3 hi = cell_of(m_proxies[i].aabb.max);
+            for (int x = lo.x; x <= hi.x; ++x) {
+                for (int y = lo.y; y <= hi.y; ++y) {
+                    for (int z = lo.z; z <= hi.z; ++z) {
+                        m_entries[out++] = { cell_key({ x, y, z }), static_cast<uint32_t>(i) };
+                    }
+                }
+            }
+        }
+    });
+}
+
+void UniformGridBroadphase::radix_sort() {
+    constexpr size_t radix = 256;
+    const size_t count     = m_entries.size();
+    auto pool              = get_thread_pool();
+    const size_t chunks    = pool->chunk_count(count, 4096);
+    if (chunks == 0)
+        return;
+    m_scratch.resize(count);
+    std::vector<size_t> histograms(chunks * radix);
+    // Least significant digit first, eight bits per pass; the sort is stable so proxies stay ordered inside a cell
+    for (int shift = 0; shift < 64; shift += 8) {
+        std::fill(histograms.begin(), histograms.end(), 0);
+        pool->parallel_for(count, 4096, [&](size_t chunk, size_t begin, size_t end) {
+            size_t *histogram = &histograms[chunk * radix];
+            for (size_t i = begin; i < end; ++i) {
+                ++histogram[(m_entries[i].key >> shift) & (radix - 1)];
+            }
+        });
+        // Skip passes where every key shares the same digit
+        bool single_digit = false;
+        for (size_t digit = 0; digit < radix && !single_digit; ++digit) {
+            size_t total = 0;
+            for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                total += histograms[chunk * radix + digit];
+            }
+            single_digit = total == count;
+        }
+        if (single_digit)
+            continue;
+        // Exclusive prefix sum ordered by digit, then by chunk
+        size_t offset = 0;
+        for (size_t digit = 0; digit < radix; ++digit) {
+            for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                const size_t n                    = histograms[chunk * radix + digit];
+                histograms[chunk * radix + digit] = offset;
+                offset += n;
+            }
+        }
+        pool->parallel_for(count, 4096, [&](size_t chunk, size_t begin, size_t end) {
+            size_t *offsets = &histograms[chunk * radix];
+            for (size_t i = begin; i < end; ++i) {
+                m_scratch[offsets[(m_entries[i].key >> shift) & (radix - 1)]++] = m_entries[i];
+            }
+        });
+        m_entries.swap(m_scratch);
+    }
+}
+
+void UniformGridBroadphase::find_pairs(std::vector<BroadphasePair> &pairs) {
+    // Runs of equal keys are the occupied cells
+    m_cell_starts.clear();
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        if (i == 0 || m_entries[i].key != m_entries[i - 1].key)
+            m_cell_starts.push_back(i);
+    }
+    const size_t cell_count = m_cell_starts.size();
+    m_cell_starts.push_back(m_entries.size());
+
+    auto pool = get_thread_pool();
+    m_chunk_pairs.resize(std::max<size_t>(pool->chunk_count(cell_count, 64), 1) +
+                         std::max<size_t>(pool->chunk_count(m_large_proxies.size(), 4), 1));
+    for (auto &buffer : m_chunk_pairs) {
+        buffer.clear();
+    }
+
+    pool->parallel_for(cell_count, 64, [&](size_t chunk, size_t begin, size_t end) {
+        auto &buffer = m_chunk_pairs[chunk];
+        for (size_t cell = begin; cell < end; ++cell) {
+            const size_t first = m_cell_starts[cell];
+            const size_t last  = m_cell_starts[cell + 1];
+            const uint64_t key = m_entries[first].key;
+            for (size_t i = first; i < last; ++i) {
+                const auto &a = m_proxies[m_entries[i].proxy];
+                for (size_t j = i + 1; j < last; ++j) {
+                    const auto &b = m_proxies[m_entries[j].proxy];
+                    if (!can_pair(a, b) || !a.aabb.overlaps(b.aabb))
+                        continue;
+                    // Report the pair only from the cell containing the lower corner of the shared region
+                    if (cell_key(cell_of(glm::max(a.aabb.min, b.aabb.min))) != key)
+                        continue;
+                    buffer.push_back({ a.entity, b.entity });
+                }
+            }
+        }
+    });
+
+    // Oversized proxies are tested against everything, pairs of two large proxies reported once
+    const size_t large_base = m_chunk_pairs.size() - std::max<size_t>(pool->chunk_count(m_large_proxies.size(), 4), 1);
+    pool->parallel_for(m_large_proxies.size(), 4, [&](size_t chunk, size_t begin, size_t end) {
+        auto &buffer = m_chunk_pairs[large_base + chunk];
+        for (size_t l = begin; l < end; ++l) {
+            const uint32_t large = m_large_proxies[l];
+            const auto &a        = m_proxies[large];
+            for (uint32_t other = 0; other < m_proxies.size(); ++other) {
+                if (other == large)
+                    continue;
+                const bool other_is_large = m_entry_offsets[other] == m_entry_offsets[other + 1];
+                if ((other_is_large && other < large) || !can_pair(a, m_proxies[other]))
+                    continue;
+                if (a.aabb.overlaps(m_proxies[other].aabb))
+                    buffer.push_back({ a.entity, m_proxies[other].entity });
+            }
+        }
+    });
+
+    // Merge in chunk order so the result does not depend on thread timing
+    for (const auto &buffer : m_chunk_pairs) {
+        pairs.insert(pairs.end(), buffer.begin(), buffer.end());
+    }
+}
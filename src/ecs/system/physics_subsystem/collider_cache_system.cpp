@@ -0,0 +1,41 @@
+#include <core/parallel/thread_pool.h>
+#include <ecs/component/groups.h>
+#include <ecs/system/physics_subsystem/collider_cache_system.h>
+
+int ColliderCacheSystem::execution_priority() const { return priority; }
+
+void ColliderCacheSystem::update(entt::registry &registry, float dt) {
+    if (observed_registry != &registry) {
+        registry.on_construct<Collider>().connect<&ColliderCacheSystem::bump_version>();
+        registry.on_update<Collider>().connect<&ColliderCacheSystem::bump_version>();
+        observed_registry = &registry;
+    }
+    // Colliders join the collider group with their cache. Missing caches are created up front, the parallel pass
+    // must not change the registry layout.
+    entities.clear();
+    for (const auto entity : registry.view<Transform, Collider>(entt::exclude<ColliderCache>))
+        entities.push_back(entity);
+    for (const auto entity : entities)
+        registry.emplace<ColliderCache>(entity);
+    entities.clear();
+    each_collider(registry, [&](auto entity, const Collider &collider, const ColliderCache &cache, const Transform &t) {
+        // Colliders that neither moved nor changed keep their cache, which takes static scenery out of the step
+        if (collider.is_active &&
+            (cache.transform_version != t.get_world_version() || cache.collider_version != collider.version))
+            entities.push_back(entity);
+    });
+    get_thread_pool()->parallel_for(entities.size(), 128, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const auto entity = entities[i];
+            auto &cache       = registry.get<ColliderCache>(entity);
+            cache.refresh(registry.get<Transform>(entity), registry.get<Collider>(entity));
+        }
+    });
+}
+
+void ColliderCacheSystem::bump_version(entt::registry &registry, entt::entity entity) {
+    // A replaced collider may carry any version, possibly the one its cache was built from. Moving past the cached
+    // one also changes what the scene query snapshot compares against, so it picks up the new shape too.
+    if (const auto *cache = registry.try_get<ColliderCache>(entity))
+        registry.get<Collider>(entity).version = cache->collider_version + 1;
+}
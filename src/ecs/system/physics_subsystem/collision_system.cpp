@@ -1,160 +1,797 @@
+#include <algorithm>
+#include <core/parallel/thread_pool.h>
 #include <ecs/component/collider.h>
+#include <ecs/component/compound_shape.h>
+#include <ecs/component/groups.h>
 #include <ecs/component/rigidbody.h>
 #include <ecs/component/transform.h>
+#include <ecs/system/physics_subsystem/broadphase/aabb_tree_broadphase.h>
+#include <ecs/system/physics_subsystem/broadphase/sweep_and_prune.h>
+#include <ecs/system/physics_subsystem/broadphase/uniform_grid.h>
 #include <ecs/system/physics_subsystem/collision_system.h>
-#include <glm/gtc/quaternion.hpp>
+#include <ecs/system/physics_subsystem/contact_events.h>
+#include <ecs/system/physics_subsystem/narrowphase/batch_kernels.h>
+#include <ecs/system/physics_subsystem/narrowphase/gjk_epa.h>
+#include <ecs/system/physics_subsystem/transform_hierarchy.h>
+
+CollisionSystem::CollisionSystem(BroadphaseType broadphase_type) : broadphase(create_broadphase(broadphase_type)) {}
 
 int CollisionSystem::execution_priority() const { return priority; }
 
 void CollisionSystem::update(entt::registry &registry, float dt) {
+    detach_woken_bodies(registry);
     detect_collisions(registry);
+    publish_contact_events(registry);
     resolve_collisions(registry, dt);
+    update_sleep(registry, dt);
+}
+
+void CollisionSystem::set_broadphase(BroadphaseType type) { broadphase = create_broadphase(type); }
+
+void CollisionSystem::set_solver_iterations(int iterations) { solver_iterations = std::max(iterations, 1); }
+
+std::unique_ptr<Broadphase> CollisionSystem::create_broadphase(BroadphaseType type) {
+    switch (type) {
+        case BroadphaseType::AabbTree:
+            return std::make_unique<AabbTreeBroadphase>();
+        case BroadphaseType::UniformGrid:
+            return std::make_unique<UniformGridBroadphase>();
+        case BroadphaseType::SweepAndPrune:
+        default:
+            return std::make_unique<SweepAndPrune>();
+    }
 }
 
 void CollisionSystem::detect_collisions(entt::registry &registry) {
     collision_pairs.clear();
-    auto view = registry.view<Transform, Collider>();
-    std::vector<entt::entity> entities;
-    view.each([&](auto entity, auto &&...) { entities.push_back(entity); });
-    // Optimized pair checking with early rejection
-    for (size_t i = 0; i < entities.size(); ++i) {
-        for (size_t j = i + 1; j < entities.size(); ++j) {
-            const auto ent_a    = entities[i];
-            const auto ent_b    = entities[j];
-            const auto &trans_a = view.get<Transform>(ent_a);
-            const auto &coll_a  = view.get<Collider>(ent_a);
-            const auto &trans_b = view.get<Transform>(ent_b);
-            const auto &coll_b  = view.get<Collider>(ent_b);
-            if (!coll_a.is_active || !coll_b.is_active)
+    trigger_pairs.clear();
+    proxies.clear();
+    candidate_pairs.clear();
+    fast_bodies.clear();
+    planes.clear();
+    // Lookups by entity below, a view works with either layout of each_collider
+    auto view = registry.view<Collider, ColliderCache>();
+    each_collider(registry, [&](auto entity, const Collider &collider, const ColliderCache &cache, const Transform &t) {
+        if (!collider.is_active)
+            return;
+        if (collider.shape == Collider::PLANE) {
+            planes.push_back({ entity, cache.aabb, true, collider.is_trigger, collider.layer, collider.mask });
+            return;
+        }
+        // Colliders without a simulated rigid body never move on their own, sleeping ones not until woken. Children
+        // are carried by their parent like kinematic bodies, and their local position says nothing about the motion
+        // a sweep would need
+        const auto *rb       = registry.try_get<RigidBody>(entity);
+        const bool is_static = !rb || rb->mass <= 0.0f || rb->is_sleeping;
+        AABB aabb            = cache.aabb;
+        if (!is_static && rb->is_fast && !rb->is_kinematic && t.parent == entt::null && !collider.is_trigger) {
+            // Bounds of the whole motion, so the broadphase reports everything the body passed on its way
+            const glm::vec3 motion = rb->previous_position - t.position;
+            aabb                   = AABB::merge(aabb, { aabb.min + motion, aabb.max + motion });
+            fast_bodies.push_back(entity);
+        }
+        proxies.push_back({ entity, aabb, is_static, collider.is_trigger, collider.layer, collider.mask });
+    });
+    // Broadphase: only pairs with overlapping bounds reach the narrowphase
+    broadphase->update(proxies);
+    broadphase->find_pairs(candidate_pairs);
+    // A handful of planes, each tested against the lowest corner of every moving proxy's bounds
+    for (const auto &plane : planes) {
+        const auto &plane_cache = view.get<ColliderCache>(plane.entity);
+        const glm::vec3 normal  = plane_cache.basis[1];
+        const float offset      = glm::dot(normal, plane_cache.center);
+        for (const auto &proxy : proxies) {
+            if (!can_pair(plane, proxy))
                 continue;
+            glm::vec3 lowest;
+            for (int i = 0; i < 3; ++i)
+                lowest[i] = normal[i] > 0.0f ? proxy.aabb.min[i] : proxy.aabb.max[i];
+            if (glm::dot(normal, lowest) <= offset)
+                candidate_pairs.push_back({ plane.entity, proxy.entity });
+        }
+    }
+    advance_fast_bodies(registry);
+    // Narrowphase: pairs are independent, each chunk writes to its own buffer
+    auto pool = get_thread_pool();
+    const size_t chunks = std::max<size_t>(pool->chunk_count(candidate_pairs.size(), narrowphase_grain), 1);
+    chunk_pairs.resize(chunks);
+    chunk_triggers.resize(chunks);
+    chunk_batches.resize(chunks);
+    chunk_axes.resize(chunks);
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        chunk_pairs[chunk].clear();
+        chunk_triggers[chunk].clear();
+        chunk_axes[chunk].clear();
+        chunk_batches[chunk].sphere_sphere.clear();
+        chunk_batches[chunk].sphere_box.clear();
+        chunk_batches[chunk].capsule_capsule.clear();
+    }
+    pool->parallel_for(candidate_pairs.size(), narrowphase_grain, [&](size_t chunk, size_t begin, size_t end) {
+        auto &buffer   = chunk_pairs[chunk];
+        auto &triggers = chunk_triggers[chunk];
+        auto &batches  = chunk_batches[chunk];
+        auto &axes     = chunk_axes[chunk];
+        for (size_t i = begin; i < end; ++i) {
+            auto [ent_a, ent_b] = candidate_pairs[i];
+            // Canonical pair order keeps contact cache keys stable across frames
+            if (ent_b < ent_a)
+                std::swap(ent_a, ent_b);
+            const auto &[coll_a, cache_a] = view.get<Collider, ColliderCache>(ent_a);
+            const auto &[coll_b, cache_b] = view.get<Collider, ColliderCache>(ent_b);
             CollisionManifold manifold{};
-            if (collide(trans_a, coll_a, trans_b, coll_b, manifold)) {
-                collision_pairs.push_back({ ent_a, ent_b, manifold });
+            // Trigger overlaps are recorded but never reach the solver
+            if (coll_a.is_trigger || coll_b.is_trigger) {
+                if (collide(coll_a, cache_a, coll_b, cache_b, manifold))
+                    triggers.push_back({ ent_a, ent_b });
+                continue;
+            }
+            // Box pairs start from the axis that decided them last step, the cache is only read while in parallel
+            if (coll_a.shape == Collider::BOX && coll_b.shape == Collider::BOX) {
+                const CachedAxis key{ ent_a, ent_b, UINT32_MAX };
+                const auto it    = std::lower_bound(previous_box_axes.begin(), previous_box_axes.end(), key);
+                const bool found = it != previous_box_axes.end() && it->a == ent_a && it->b == ent_b;
+                uint32_t axis    = found ? it->axis : UINT32_MAX;
+                if (box_vs_box(coll_a, cache_a, coll_b, cache_b, manifold, &axis))
+                    buffer.push_back({ ent_a, ent_b, manifold });
+                axes.push_back({ ent_a, ent_b, axis });
+                continue;
+            }
+            // Common primitive pairs are tested batch_width at a time after the loop
+            if (enqueue_batched({ ent_a, ent_b, &coll_a, &coll_b, &cache_a, &cache_b, false }, batches))
+                continue;
+            if (collide(coll_a, cache_a, coll_b, cache_b, manifold)) {
+                buffer.push_back({ ent_a, ent_b, manifold });
             }
         }
+        collide_batched(batches, buffer);
+    });
+    // Merge in chunk order so the contact order does not depend on thread timing
+    for (const auto &buffer : chunk_pairs) {
+        collision_pairs.insert(collision_pairs.end(), buffer.begin(), buffer.end());
+    }
+    for (const auto &buffer : chunk_triggers) {
+        trigger_pairs.insert(trigger_pairs.end(), buffer.begin(), buffer.end());
     }
+    // Pairs that left the broadphase drop their cached axis
+    box_axes.clear();
+    for (const auto &buffer : chunk_axes)
+        box_axes.insert(box_axes.end(), buffer.begin(), buffer.end());
+    std::sort(box_axes.begin(), box_axes.end());
+    std::swap(box_axes, previous_box_axes);
+    wake_touched_islands(registry);
 }
 
-void CollisionSystem::resolve_collisions(entt::registry &registry, float dt) {
-    for (auto &pair : collision_pairs) {
-        auto [ent_a, ent_b, manifold] = pair;
-        auto *rb_a                    = registry.try_get<RigidBody>(ent_a);
-        auto *rb_b                    = registry.try_get<RigidBody>(ent_b);
-        auto *trans_a                 = registry.try_get<Transform>(ent_a);
-        auto *trans_b                 = registry.try_get<Transform>(ent_b);
-        // Skip trigger interactions
+void CollisionSystem::advance_fast_bodies(entt::registry &registry) {
+    if (fast_bodies.empty())
+        return;
+    std::sort(fast_bodies.begin(), fast_bodies.end());
+    auto is_fast = [&](entt::entity entity) {
+        return std::binary_search(fast_bodies.begin(), fast_bodies.end(), entity);
+    };
+    swept_pairs.clear();
+    for (const auto &[ent_a, ent_b] : candidate_pairs) {
+        // Triggers never stop a body
         if (registry.get<Collider>(ent_a).is_trigger || registry.get<Collider>(ent_b).is_trigger)
             continue;
-        // Calculate relative positions
-        const glm::vec3 r_a = manifold.contact_point - trans_a->position;
-        const glm::vec3 r_b = manifold.contact_point - trans_b->position;
-        // Calculate velocities with proper null checks
-        const glm::vec3 vel_a   = rb_a ? rb_a->linear_velocity + glm::cross(rb_a->angular_velocity, r_a) : glm::vec3(0);
-        const glm::vec3 vel_b   = rb_b ? rb_b->linear_velocity + glm::cross(rb_b->angular_velocity, r_b) : glm::vec3(0);
-        const glm::vec3 rel_vel = vel_a - vel_b;
-        // Normal impulse calculation
-        const float restitution = std::min(manifold.combined_restitution, 1.0f);
-        float numerator         = -(1.0f + restitution) * glm::dot(rel_vel, manifold.normal);
-        // Handle infinite masses safely
-        const float inv_mass_a    = (rb_a && rb_a->mass > 0.0f) ? 1.0f / rb_a->mass : 0.0f;
-        const float inv_mass_b    = (rb_b && rb_b->mass > 0.0f) ? 1.0f / rb_b->mass : 0.0f;
-        const glm::vec3 cross_a   = glm::cross(r_a, manifold.normal);
-        const glm::vec3 cross_b   = glm::cross(r_b, manifold.normal);
-        const float inv_inertia_a = rb_a ? glm::dot(cross_a, rb_a->inv_inertia_tensor * cross_a) : 0.0f;
-        const float inv_inertia_b = rb_b ? glm::dot(cross_b, rb_b->inv_inertia_tensor * cross_b) : 0.0f;
-        float denominator         = inv_mass_a + inv_mass_b + inv_inertia_a + inv_inertia_b;
-        if (denominator <= 0.0f)
+        if (is_fast(ent_a))
+            swept_pairs.push_back({ ent_a, ent_b, 1.0f });
+        if (is_fast(ent_b))
+            swept_pairs.push_back({ ent_b, ent_a, 1.0f });
+    }
+    if (swept_pairs.empty())
+        return;
+    std::sort(swept_pairs.begin(), swept_pairs.end(), [](const SweptPair &lhs, const SweptPair &rhs) {
+        return lhs.body != rhs.body ? lhs.body < rhs.body : lhs.other < rhs.other;
+    });
+    // Sweeps only read the registry, every pair is independent
+    get_thread_pool()->parallel_for(swept_pairs.size(), 16, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            auto &pair             = swept_pairs[i];
+            const auto &trans      = registry.get<Transform>(pair.body);
+            const glm::vec3 motion = trans.position - registry.get<RigidBody>(pair.body).previous_position;
+            pair.time_of_impact =
+                time_of_impact(registry.get<Collider>(pair.body), registry.get<ColliderCache>(pair.body), motion,
+                               registry.get<Collider>(pair.other), registry.get<ColliderCache>(pair.other));
+        }
+    });
+    // Clamp each body to its earliest impact; fast pairs were swept against the other body's end pose
+    for (size_t begin = 0, end = 0; begin < swept_pairs.size(); begin = end) {
+        const entt::entity body = swept_pairs[begin].body;
+        float time              = 1.0f;
+        for (end = begin; end < swept_pairs.size() && swept_pairs[end].body == body; ++end)
+            time = std::min(time, swept_pairs[end].time_of_impact);
+        if (time >= 1.0f)
             continue;
-        const float impulse_magnitude = numerator / denominator;
-        const glm::vec3 impulse       = impulse_magnitude * manifold.normal;
-        // Apply impulses with mass validation
-        if (rb_a && rb_a->mass > 0.0f) {
-            rb_a->linear_velocity += impulse * inv_mass_a;
-            rb_a->angular_velocity += rb_a->inv_inertia_tensor * glm::cross(r_a, impulse);
-        }
-        if (rb_b && rb_b->mass > 0.0f) {
-            rb_b->linear_velocity -= impulse * inv_mass_b;
-            rb_b->angular_velocity -= rb_b->inv_inertia_tensor * glm::cross(r_b, impulse);
-        }
-        // Friction handling
-        glm::vec3 tangent = rel_vel - glm::dot(rel_vel, manifold.normal) * manifold.normal;
-        if (glm::length(tangent) > 1e-6f) {
-            tangent   = glm::normalize(tangent);
-            numerator = -glm::dot(rel_vel, tangent);
-            denominator =
-                inv_mass_a + inv_mass_b +
-                glm::dot(glm::cross(rb_a ? rb_a->inv_inertia_tensor * glm::cross(r_a, tangent) : glm::vec3(0), r_a),
-                         tangent) +
-                glm::dot(glm::cross(rb_b ? rb_b->inv_inertia_tensor * glm::cross(r_b, tangent) : glm::vec3(0), r_b),
-                         tangent);
-
-            if (denominator <= 0)
-                continue;
+        auto &trans          = registry.get<Transform>(body);
+        const auto &previous = registry.get<RigidBody>(body).previous_position;
+        trans.position       = previous + (trans.position - previous) * time;
+        registry.get<ColliderCache>(body).refresh(trans, registry.get<Collider>(body));
+    }
+}
 
-            float jt = numerator / denominator;
-            float mu = manifold.combined_friction;
-            jt       = glm::clamp(jt, -impulse_magnitude * mu, impulse_magnitude * mu);
+float CollisionSystem::time_of_impact(const Collider &c, const ColliderCache &end, const glm::vec3 &motion,
+                                      const Collider &other_c, const ColliderCache &other_w) {
+    CollisionManifold manifold{};
+    auto touches = [&](float time) {
+        return collide(c, translated(end, motion * (time - 1.0f)), other_c, other_w, manifold);
+    };
+    // Already touching at the start: the regular contact handles it, and clamping would pin the body in place
+    if (touches(0.0f))
+        return 1.0f;
+    // Step in fractions of the smallest half extent so no collider thicker than a step is skipped
+    const glm::vec3 half_extent = (end.aabb.max - end.aabb.min) * 0.5f;
+    const float step_length =
+        std::max(std::min({ half_extent.x, half_extent.y, half_extent.z }), 1e-4f) / toi_steps_per_extent;
+    const int steps = std::clamp(static_cast<int>(std::ceil(glm::length(motion) / step_length)), 1, max_toi_steps);
+    for (int i = 1; i <= steps; ++i) {
+        float hit = static_cast<float>(i) / static_cast<float>(steps);
+        if (!touches(hit))
+            continue;
+        // Refine between the last free and the first touching pose, keeping the touching side
+        float free = static_cast<float>(i - 1) / static_cast<float>(steps);
+        for (int j = 0; j < toi_refinements; ++j) {
+            const float middle = (free + hit) * 0.5f;
+            if (touches(middle))
+                hit = middle;
+            else
+                free = middle;
+        }
+        return hit;
+    }
+    return 1.0f;
+}
 
-            glm::vec3 frictionImpulse = jt * tangent;
+ColliderCache CollisionSystem::translated(const ColliderCache &cache, const glm::vec3 &offset) {
+    ColliderCache moved = cache;
+    moved.matrix[3] += glm::vec4(offset, 0.0f);
+    moved.inverse_matrix[3] -= moved.inverse_matrix * glm::vec4(offset, 0.0f);
+    moved.center += offset;
+    moved.capsule_base += offset;
+    moved.capsule_top += offset;
+    moved.aabb.min += offset;
+    moved.aabb.max += offset;
+    return moved;
+}
 
-            if (rb_a) {
-                rb_a->linear_velocity += frictionImpulse * inv_mass_a;
-                rb_a->angular_velocity += rb_a->inv_inertia_tensor * glm::cross(r_a, frictionImpulse);
-            }
-            if (rb_b) {
-                rb_b->linear_velocity -= frictionImpulse * inv_mass_b;
-                rb_b->angular_velocity -= rb_b->inv_inertia_tensor * glm::cross(r_b, frictionImpulse);
+bool CollisionSystem::enqueue_batched(const BatchedPair &pair, NarrowphaseBatches &batches) {
+    const auto shape_a = pair.collider_a->shape;
+    const auto shape_b = pair.collider_b->shape;
+    if (shape_a == Collider::SPHERE && shape_b == Collider::SPHERE) {
+        batches.sphere_sphere.push_back(pair);
+    } else if (shape_a == Collider::SPHERE && shape_b == Collider::BOX) {
+        batches.sphere_box.push_back(pair);
+    } else if (shape_a == Collider::BOX && shape_b == Collider::SPHERE) {
+        batches.sphere_box.push_back({ pair.a, pair.b, pair.collider_b, pair.collider_a, pair.cache_b, pair.cache_a,
+                                       true });
+    } else if (shape_a == Collider::CAPSULE && shape_b == Collider::CAPSULE) {
+        batches.capsule_capsule.push_back(pair);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void CollisionSystem::collide_batched(const NarrowphaseBatches &batches, std::vector<CollisionPair> &out) {
+    ContactLanes contacts;
+    // Scatter the hit lanes of one batch back into manifolds
+    auto scatter = [&](const std::vector<BatchedPair> &pairs, size_t first, size_t count) {
+        for (size_t lane = 0; lane < count; ++lane) {
+            if (!contacts.hit[lane])
+                continue;
+            const auto &pair = pairs[first + lane];
+            const glm::vec3 normal(contacts.normal_x[lane], contacts.normal_y[lane], contacts.normal_z[lane]);
+            const glm::vec3 point(contacts.point_x[lane], contacts.point_y[lane], contacts.point_z[lane]);
+            CollisionManifold manifold{};
+            manifold.normal               = pair.flipped ? -normal : normal;
+            manifold.contact_point        = point;
+            manifold.penetration_depth    = contacts.depth[lane];
+            manifold.combined_friction    = std::sqrt(pair.collider_a->friction * pair.collider_b->friction);
+            manifold.combined_restitution = std::sqrt(pair.collider_a->restitution * pair.collider_b->restitution);
+            out.push_back({ pair.a, pair.b, manifold });
+        }
+    };
+    // Unused lanes stay zeroed, zero radii never report a hit
+    auto pack_sphere = [](SphereLanes &lanes, size_t lane, const Collider &collider, const ColliderCache &cache) {
+        lanes.x[lane]      = cache.center.x;
+        lanes.y[lane]      = cache.center.y;
+        lanes.z[lane]      = cache.center.z;
+        lanes.radius[lane] = collider.radius;
+    };
+    for (size_t first = 0; first < batches.sphere_sphere.size(); first += batch_width) {
+        const size_t count = std::min(batch_width, batches.sphere_sphere.size() - first);
+        SphereLanes a{}, b{};
+        for (size_t lane = 0; lane < count; ++lane) {
+            const auto &pair = batches.sphere_sphere[first + lane];
+            pack_sphere(a, lane, *pair.collider_a, *pair.cache_a);
+            pack_sphere(b, lane, *pair.collider_b, *pair.cache_b);
+        }
+        collide_sphere_sphere(a, b, contacts);
+        scatter(batches.sphere_sphere, first, count);
+    }
+    for (size_t first = 0; first < batches.sphere_box.size(); first += batch_width) {
+        const size_t count = std::min(batch_width, batches.sphere_box.size() - first);
+        SphereLanes spheres{};
+        BoxLanes boxes{};
+        for (size_t lane = 0; lane < count; ++lane) {
+            const auto &pair = batches.sphere_box[first + lane];
+            pack_sphere(spheres, lane, *pair.collider_a, *pair.cache_a);
+            for (int column = 0; column < 4; ++column) {
+                for (int row = 0; row < 3; ++row) {
+                    boxes.matrix[column * 3 + row][lane]  = pair.cache_b->matrix[column][row];
+                    boxes.inverse[column * 3 + row][lane] = pair.cache_b->inverse_matrix[column][row];
+                }
             }
+            boxes.half_x[lane] = pair.collider_b->half_extents.x;
+            boxes.half_y[lane] = pair.collider_b->half_extents.y;
+            boxes.half_z[lane] = pair.collider_b->half_extents.z;
+        }
+        collide_sphere_box(spheres, boxes, contacts);
+        scatter(batches.sphere_box, first, count);
+    }
+    auto pack_capsule = [](CapsuleLanes &lanes, size_t lane, const Collider &collider, const ColliderCache &cache) {
+        lanes.base_x[lane] = cache.capsule_base.x;
+        lanes.base_y[lane] = cache.capsule_base.y;
+        lanes.base_z[lane] = cache.capsule_base.z;
+        lanes.top_x[lane]  = cache.capsule_top.x;
+        lanes.top_y[lane]  = cache.capsule_top.y;
+        lanes.top_z[lane]  = cache.capsule_top.z;
+        lanes.radius[lane] = collider.capsule_radius;
+    };
+    for (size_t first = 0; first < batches.capsule_capsule.size(); first += batch_width) {
+        const size_t count = std::min(batch_width, batches.capsule_capsule.size() - first);
+        CapsuleLanes a{}, b{};
+        for (size_t lane = 0; lane < count; ++lane) {
+            const auto &pair = batches.capsule_capsule[first + lane];
+            pack_capsule(a, lane, *pair.collider_a, *pair.cache_a);
+            pack_capsule(b, lane, *pair.collider_b, *pair.cache_b);
+        }
+        collide_capsule_capsule(a, b, contacts);
+        scatter(batches.capsule_capsule, first, count);
+    }
+}
+
+void CollisionSystem::wake_touched_islands(entt::registry &registry) {
+    for (const auto &[ent_a, ent_b, manifold] : collision_pairs) {
+        const auto *rb_a = registry.try_get<RigidBody>(ent_a);
+        const auto *rb_b = registry.try_get<RigidBody>(ent_b);
+        if (!rb_a || !rb_b)
+            continue;
+        const bool awake_a = !rb_a->is_sleeping && rb_a->mass > 0.0f;
+        const bool awake_b = !rb_b->is_sleeping && rb_b->mass > 0.0f;
+        if (rb_a->is_sleeping && awake_b)
+            wake_island(registry, ent_a);
+        else if (rb_b->is_sleeping && awake_a)
+            wake_island(registry, ent_b);
+    }
+}
+
+void CollisionSystem::wake_island(entt::registry &registry, entt::entity entity) {
+    const auto it = sleeping_island_of.find(entity);
+    if (it == sleeping_island_of.end()) {
+        if (auto *rb = registry.try_get<RigidBody>(entity))
+            rb->wake_up();
+        return;
+    }
+    const entt::entity representative = it->second;
+    const auto island                 = sleeping_islands.find(representative);
+    if (island == sleeping_islands.end()) {
+        sleeping_island_of.erase(it);
+        if (auto *rb = registry.try_get<RigidBody>(entity))
+            rb->wake_up();
+        return;
+    }
+    for (const auto member : island->second) {
+        // Members woken on their own since may have fallen asleep in another island
+        const auto member_it = sleeping_island_of.find(member);
+        if (member_it == sleeping_island_of.end() || member_it->second != representative)
+            continue;
+        sleeping_island_of.erase(member_it);
+        if (auto *rb = registry.valid(member) ? registry.try_get<RigidBody>(member) : nullptr)
+            rb->wake_up();
+    }
+    sleeping_islands.erase(island);
+}
+
+void CollisionSystem::detach_woken_bodies(entt::registry &registry) {
+    for (auto it = sleeping_island_of.begin(); it != sleeping_island_of.end();) {
+        const auto *rb = registry.valid(it->first) ? registry.try_get<RigidBody>(it->first) : nullptr;
+        if (rb && rb->is_sleeping) {
+            ++it;
+            continue;
+        }
+        // Woken through the body itself or destroyed, the rest of its island keeps sleeping
+        if (const auto island = sleeping_islands.find(it->second); island != sleeping_islands.end()) {
+            auto &members = island->second;
+            members.erase(std::remove(members.begin(), members.end(), it->first), members.end());
+            if (members.empty())
+                sleeping_islands.erase(island);
+        }
+        it = sleeping_island_of.erase(it);
+    }
+}
+
+void CollisionSystem::update_sleep(entt::registry &registry, float dt) {
+    auto put_to_sleep = [&](entt::entity entity, RigidBody &rb, entt::entity representative) {
+        rb.sleep();
+        // Bodies still listed under the representative are asleep too (see detach_woken_bodies), so the list is
+        // appended to rather than replaced and they wake together with the new members
+        sleeping_island_of[entity] = representative;
+        sleeping_islands[representative].push_back(entity);
+    };
+    // Bodies without contacts form an island of their own, the others have to wait for their island
+    island_awake.assign(body_parents.size(), 0);
+    registry.view<RigidBody>().each([&](auto entity, RigidBody &rb) {
+        if (rb.is_kinematic || rb.is_sleeping || rb.mass <= 0.0f)
+            return;
+        const bool resting = rb.update_sleep_timer(dt);
+        if (const auto it = body_nodes.find(entity); it != body_nodes.end()) {
+            if (!resting)
+                island_awake[find_root(body_parents, it->second)] = 1;
+        } else if (resting) {
+            put_to_sleep(entity, rb, entity);
+        }
+    });
+    node_entities.resize(body_parents.size());
+    for (const auto &[entity, node] : body_nodes)
+        node_entities[node] = entity;
+    // Roots are the smallest node of their set, so each island's representative is visited first
+    for (uint32_t node = 0; node < body_parents.size(); ++node) {
+        const uint32_t root = find_root(body_parents, node);
+        if (island_awake[root])
+            continue;
+        const entt::entity representative = node_entities[root];
+        put_to_sleep(node_entities[node], registry.get<RigidBody>(node_entities[node]), representative);
+    }
+}
+
+void CollisionSystem::publish_contact_events(entt::registry &registry) {
+    auto &events = registry.ctx().emplace<ContactEvents>();
+    events.begin_frame();
+    touching_pairs.clear();
+    for (uint32_t i = 0; i < collision_pairs.size(); ++i)
+        touching_pairs.push_back({ collision_pairs[i].a, collision_pairs[i].b, false, i });
+    for (const auto &[ent_a, ent_b] : trigger_pairs)
+        touching_pairs.push_back({ ent_a, ent_b, true, UINT32_MAX });
+    auto by_entities = [](const TouchingPair &lhs, const TouchingPair &rhs) {
+        return lhs.a != rhs.a ? lhs.a < rhs.a : lhs.b < rhs.b;
+    };
+    std::sort(touching_pairs.begin(), touching_pairs.end(), by_entities);
+    auto emit = [&](ContactEvent::Type type, const TouchingPair &pair) {
+        ContactEvent event{ type, pair.is_trigger, pair.a, pair.b, glm::vec3(0.0f), glm::vec3(0.0f), 0.0f };
+        if (type != ContactEvent::END && pair.pair_index != UINT32_MAX) {
+            const auto &manifold    = collision_pairs[pair.pair_index].manifold;
+            event.normal            = manifold.normal;
+            event.contact_point     = manifold.contact_point;
+            event.penetration_depth = manifold.penetration_depth;
+        }
+        events.push(event);
+    };
+    auto is_sleeping = [&](entt::entity entity) {
+        const auto *rb = registry.valid(entity) ? registry.try_get<RigidBody>(entity) : nullptr;
+        return rb && rb->is_sleeping;
+    };
+    // Merge both sorted sets; pairs carried over while asleep are appended behind the current ones
+    const size_t current_count = touching_pairs.size();
+    size_t i = 0, j = 0;
+    while (i < current_count || j < previous_touching_pairs.size()) {
+        if (j == previous_touching_pairs.size() ||
+            (i < current_count && by_entities(touching_pairs[i], previous_touching_pairs[j]))) {
+            emit(ContactEvent::BEGIN, touching_pairs[i++]);
+        } else if (i == current_count || by_entities(previous_touching_pairs[j], touching_pairs[i])) {
+            const auto &pair = previous_touching_pairs[j++];
+            if (is_sleeping(pair.a) || is_sleeping(pair.b))
+                touching_pairs.push_back({ pair.a, pair.b, pair.is_trigger, UINT32_MAX });
+            else
+                emit(ContactEvent::END, pair);
+        } else {
+            emit(ContactEvent::STAY, touching_pairs[i++]);
+            ++j;
+        }
+    }
+    std::inplace_merge(touching_pairs.begin(), touching_pairs.begin() + current_count, touching_pairs.end(),
+                       by_entities);
+    std::swap(touching_pairs, previous_touching_pairs);
+}
+
+void CollisionSystem::resolve_collisions(entt::registry &registry, float dt) {
+    prepare_contacts(registry);
+    build_islands();
+    // Islands share no dynamic body, so they can be solved on different threads without synchronization
+    get_thread_pool()->parallel_for(islands.size(), 1, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            solve_island(registry, islands[i]);
+    });
+    store_impulses();
+    follow_moved_parents(registry);
+}
+
+void CollisionSystem::build_islands() {
+    islands.clear();
+    body_nodes.clear();
+    body_parents.clear();
+    auto node_of = [&](entt::entity entity) {
+        const auto [it, inserted] = body_nodes.try_emplace(entity, static_cast<uint32_t>(body_parents.size()));
+        if (inserted)
+            body_parents.push_back(it->second);
+        return it->second;
+    };
+    // Union the dynamic bodies of every contact
+    for (const auto &contact : contacts) {
+        const bool dynamic_a  = contact.inv_mass_a > 0.0f;
+        const bool dynamic_b  = contact.inv_mass_b > 0.0f;
+        const uint32_t node_a = dynamic_a ? node_of(contact.a) : 0;
+        const uint32_t node_b = dynamic_b ? node_of(contact.b) : 0;
+        if (!dynamic_a || !dynamic_b)
+            continue;
+        const uint32_t root_a = find_root(body_parents, node_a);
+        const uint32_t root_b = find_root(body_parents, node_b);
+        // Link towards the smaller index so the result does not depend on hash map order
+        if (root_a != root_b)
+            body_parents[std::max(root_a, root_b)] = std::min(root_a, root_b);
+    }
+    // Number islands by first appearance and count their contacts
+    std::vector<uint32_t> root_islands(body_parents.size(), UINT32_MAX);
+    std::vector<size_t> island_sizes;
+    contact_islands.resize(contacts.size());
+    for (size_t i = 0; i < contacts.size(); ++i) {
+        const auto &contact    = contacts[i];
+        const entt::entity key = contact.inv_mass_a > 0.0f ? contact.a : contact.b;
+        const uint32_t root    = find_root(body_parents, body_nodes.at(key));
+        if (root_islands[root] == UINT32_MAX) {
+            root_islands[root] = static_cast<uint32_t>(island_sizes.size());
+            island_sizes.push_back(0);
+        }
+        contact_islands[i] = root_islands[root];
+        ++island_sizes[contact_islands[i]];
+    }
+    // Stable counting sort of the contacts by island
+    size_t offset = 0;
+    for (const size_t size : island_sizes) {
+        islands.push_back({ offset, offset });
+        offset += size;
+    }
+    sorted_contacts.resize(contacts.size());
+    for (size_t i = 0; i < contacts.size(); ++i)
+        sorted_contacts[islands[contact_islands[i]].end++] = contacts[i];
+    contacts.swap(sorted_contacts);
+}
+
+uint32_t CollisionSystem::find_root(std::vector<uint32_t> &parents, uint32_t node) {
+    while (parents[node] != node) {
+        parents[node] = parents[parents[node]]; // Path halving
+        node          = parents[node];
+    }
+    return node;
+}
+
+void CollisionSystem::solve_island(entt::registry &registry, const Island &island) {
+    warm_start(island.begin, island.end);
+    for (int i = 0; i < solver_iterations; ++i)
+        solve_velocities(island.begin, island.end);
+    correct_positions(registry, island.begin, island.end);
+}
+
+void CollisionSystem::prepare_contacts(entt::registry &registry) {
+    contacts.clear();
+    contacts.reserve(collision_pairs.size());
+    for (const auto &[ent_a, ent_b, manifold] : collision_pairs) {
+        const auto *trans_a = registry.try_get<Transform>(ent_a);
+        const auto *trans_b = registry.try_get<Transform>(ent_b);
+        if (!trans_a || !trans_b)
+            continue;
+        ContactConstraint contact{};
+        contact.a    = ent_a;
+        contact.b    = ent_b;
+        contact.rb_a = registry.try_get<RigidBody>(ent_a);
+        contact.rb_b = registry.try_get<RigidBody>(ent_b);
+        // Kinematic and massless bodies take part with infinite mass, and so do children: the solver would write
+        // world-space corrections into their local position
+        const bool dynamic_a      = contact.rb_a && contact.rb_a->mass > 0.0f && !contact.rb_a->is_kinematic &&
+                                    trans_a->parent == entt::null;
+        const bool dynamic_b      = contact.rb_b && contact.rb_b->mass > 0.0f && !contact.rb_b->is_kinematic &&
+                                    trans_b->parent == entt::null;
+        contact.inv_mass_a        = dynamic_a ? 1.0f / contact.rb_a->mass : 0.0f;
+        contact.inv_mass_b        = dynamic_b ? 1.0f / contact.rb_b->mass : 0.0f;
+        contact.inv_inertia_a     = dynamic_a ? contact.rb_a->inv_inertia_tensor : glm::mat3(0.0f);
+        contact.inv_inertia_b     = dynamic_b ? contact.rb_b->inv_inertia_tensor : glm::mat3(0.0f);
+        contact.feature           = manifold.feature_id;
+        contact.normal            = manifold.normal;
+        contact.r_a               = manifold.contact_point - glm::vec3(trans_a->world_matrix()[3]);
+        contact.r_b               = manifold.contact_point - glm::vec3(trans_b->world_matrix()[3]);
+        contact.friction          = manifold.combined_friction;
+        contact.penetration_depth = manifold.penetration_depth;
+        // Deterministic tangent basis so cached friction maps back onto the same directions
+        const glm::vec3 &n  = contact.normal;
+        contact.tangents[0] = std::abs(n.x) >= 0.57735f ? glm::normalize(glm::vec3(n.y, -n.x, 0.0f))
+                                                        : glm::normalize(glm::vec3(0.0f, n.z, -n.y));
+        contact.tangents[1] = glm::cross(n, contact.tangents[0]);
+        // Effective masses along the normal and both tangents
+        auto effective_mass = [&](const glm::vec3 &axis) {
+            const glm::vec3 cross_a = glm::cross(contact.r_a, axis);
+            const glm::vec3 cross_b = glm::cross(contact.r_b, axis);
+            const float k           = contact.inv_mass_a + contact.inv_mass_b +
+                            glm::dot(cross_a, contact.inv_inertia_a * cross_a) +
+                            glm::dot(cross_b, contact.inv_inertia_b * cross_b);
+            return k > 0.0f ? 1.0f / k : 0.0f;
+        };
+        contact.normal_mass = effective_mass(n);
+        if (contact.normal_mass <= 0.0f)
+            continue;
+        contact.tangent_mass[0] = effective_mass(contact.tangents[0]);
+        contact.tangent_mass[1] = effective_mass(contact.tangents[1]);
+        // Restitution targets the pre-solve closing speed
+        const float restitution  = std::min(manifold.combined_restitution, 1.0f);
+        const float normal_speed = glm::dot(relative_velocity(contact), n);
+        contact.velocity_bias    = normal_speed < -restitution_threshold ? -restitution * normal_speed : 0.0f;
+        // Load impulses accumulated for the same contact last step
+        if (const auto it = contact_cache.find({ ent_a, ent_b, contact.feature }); it != contact_cache.end()) {
+            contact.normal_impulse     = it->second.normal_impulse;
+            contact.tangent_impulse[0] = glm::dot(it->second.tangent_impulse, contact.tangents[0]);
+            contact.tangent_impulse[1] = glm::dot(it->second.tangent_impulse, contact.tangents[1]);
+        }
+        contacts.push_back(contact);
+    }
+}
+
+void CollisionSystem::warm_start(size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        auto &contact           = contacts[i];
+        const glm::vec3 impulse = contact.normal * contact.normal_impulse +
+                                  contact.tangents[0] * contact.tangent_impulse[0] +
+                                  contact.tangents[1] * contact.tangent_impulse[1];
+        apply_impulse(contact, impulse);
+    }
+}
+
+void CollisionSystem::solve_velocities(size_t begin, size_t end) {
+    for (size_t c = begin; c < end; ++c) {
+        auto &contact = contacts[c];
+        // Friction first, bounded by the normal impulse accumulated so far
+        const float max_friction = contact.friction * contact.normal_impulse;
+        for (int i = 0; i < 2; ++i) {
+            const float tangent_speed = glm::dot(relative_velocity(contact), contact.tangents[i]);
+            const float lambda        = -contact.tangent_mass[i] * tangent_speed;
+            const float accumulated =
+                glm::clamp(contact.tangent_impulse[i] + lambda, -max_friction, max_friction);
+            apply_impulse(contact, contact.tangents[i] * (accumulated - contact.tangent_impulse[i]));
+            contact.tangent_impulse[i] = accumulated;
         }
-        // Position correction with safe division
-        constexpr float slop              = 0.01f;
-        constexpr float correction_factor = 0.8f;
-        const float total_inv_mass        = inv_mass_a + inv_mass_b;
+        // Normal impulse may only push; clamp the total, not the increment
+        const float normal_speed = glm::dot(relative_velocity(contact), contact.normal);
+        const float lambda       = -contact.normal_mass * (normal_speed - contact.velocity_bias);
+        const float accumulated  = std::max(contact.normal_impulse + lambda, 0.0f);
+        apply_impulse(contact, contact.normal * (accumulated - contact.normal_impulse));
+        contact.normal_impulse = accumulated;
+    }
+}
+
+void CollisionSystem::store_impulses() {
+    contact_cache.clear();
+    for (const auto &contact : contacts) {
+        const glm::vec3 tangent_impulse =
+            contact.tangents[0] * contact.tangent_impulse[0] + contact.tangents[1] * contact.tangent_impulse[1];
+        contact_cache[{ contact.a, contact.b, contact.feature }] = { contact.normal_impulse, tangent_impulse };
+    }
+}
+
+void CollisionSystem::correct_positions(entt::registry &registry, size_t begin, size_t end) {
+    constexpr float slop              = 0.01f;
+    constexpr float correction_factor = 0.8f;
+    for (size_t i = begin; i < end; ++i) {
+        const auto &contact        = contacts[i];
+        const float total_inv_mass = contact.inv_mass_a + contact.inv_mass_b;
         if (total_inv_mass <= 0.0f)
             continue;
-        const glm::vec3 correction =
-            correction_factor * std::max(manifold.penetration_depth - slop, 0.0f) / total_inv_mass * manifold.normal;
-        if (rb_a && rb_a->mass > 0.0f)
-            trans_a->position -= correction * inv_mass_a;
-        if (rb_b && rb_b->mass > 0.0f)
-            trans_b->position += correction * inv_mass_b;
+        const glm::vec3 correction = correction_factor * std::max(contact.penetration_depth - slop, 0.0f) /
+                                     total_inv_mass * contact.normal;
+        if (contact.inv_mass_a > 0.0f) {
+            auto &trans = registry.get<Transform>(contact.a);
+            trans.position -= correction * contact.inv_mass_a;
+            registry.get<ColliderCache>(contact.a).refresh(trans, registry.get<Collider>(contact.a));
+        }
+        if (contact.inv_mass_b > 0.0f) {
+            auto &trans = registry.get<Transform>(contact.b);
+            trans.position += correction * contact.inv_mass_b;
+            registry.get<ColliderCache>(contact.b).refresh(trans, registry.get<Collider>(contact.b));
+        }
     }
 }
 
-bool CollisionSystem::collide(const Transform &a_t, const Collider &a_c, const Transform &b_t, const Collider &b_c,
-                              CollisionManifold &out) {
+void CollisionSystem::follow_moved_parents(entt::registry &registry) {
+    auto *hierarchy = registry.ctx().find<TransformHierarchy>();
+    if (!hierarchy)
+        return;
+    // Parent links cannot have changed within the step, and only nodes that moved since the early pass are recomputed
+    hierarchy->propagate(registry);
+    hierarchy->each_changed(registry, [&](entt::entity entity) {
+        if (auto *cache = registry.try_get<ColliderCache>(entity))
+            cache->refresh(registry.get<Transform>(entity), registry.get<Collider>(entity));
+    });
+}
+
+void CollisionSystem::apply_impulse(ContactConstraint &contact, const glm::vec3 &impulse) {
+    // Impulse acts on B along the normal and on A in the opposite direction
+    if (contact.inv_mass_a > 0.0f) {
+        contact.rb_a->linear_velocity -= impulse * contact.inv_mass_a;
+        contact.rb_a->angular_velocity -= contact.inv_inertia_a * glm::cross(contact.r_a, impulse);
+    }
+    if (contact.inv_mass_b > 0.0f) {
+        contact.rb_b->linear_velocity += impulse * contact.inv_mass_b;
+        contact.rb_b->angular_velocity += contact.inv_inertia_b * glm::cross(contact.r_b, impulse);
+    }
+}
+
+glm::vec3 CollisionSystem::relative_velocity(const ContactConstraint &contact) {
+    const glm::vec3 vel_a = contact.rb_a ? contact.rb_a->linear_velocity +
+                                               glm::cross(contact.rb_a->angular_velocity, contact.r_a)
+                                         : glm::vec3(0);
+    const glm::vec3 vel_b = contact.rb_b ? contact.rb_b->linear_velocity +
+                                               glm::cross(contact.rb_b->angular_velocity, contact.r_b)
+                                         : glm::vec3(0);
+    return vel_b - vel_a;
+}
+
+bool CollisionSystem::collide(const Collider &a_c, const ColliderCache &a_w, const Collider &b_c,
+                              const ColliderCache &b_w, CollisionManifold &out) {
     const auto shape1 = a_c.shape;
     const auto shape2 = b_c.shape;
-    // Handle shape order permutations
+    // Primitives are written for one shape order; swapped calls flip the normal back to A -> B
+    const auto swapped = [&out](bool hit) {
+        out.normal = -out.normal;
+        return hit;
+    };
+    // Compounds come first, their children dispatch again and may be anything but a plane
+    if (shape1 == Collider::COMPOUND)
+        return compound_vs_shape(a_c, a_w, b_c, b_w, out);
+    if (shape2 == Collider::COMPOUND)
+        return swapped(compound_vs_shape(b_c, b_w, a_c, a_w, out));
+    if (shape1 == Collider::PLANE)
+        return plane_vs_convex(a_c, a_w, b_c, b_w, out);
+    if (shape2 == Collider::PLANE)
+        return swapped(plane_vs_convex(b_c, b_w, a_c, a_w, out));
+    if (shape1 == Collider::HEIGHTFIELD)
+        return heightfield_vs_convex(a_c, a_w, b_c, b_w, out);
+    if (shape2 == Collider::HEIGHTFIELD)
+        return swapped(heightfield_vs_convex(b_c, b_w, a_c, a_w, out));
+    if (shape1 == Collider::SDF)
+        return sdf_vs_convex(a_c, a_w, b_c, b_w, out);
+    if (shape2 == Collider::SDF)
+        return swapped(sdf_vs_convex(b_c, b_w, a_c, a_w, out));
+    if (shape1 == Collider::TRIANGLE_MESH)
+        return mesh_vs_convex(a_c, a_w, b_c, b_w, out);
+    if (shape2 == Collider::TRIANGLE_MESH)
+        return swapped(mesh_vs_convex(b_c, b_w, a_c, a_w, out));
+    if (shape1 == Collider::CONVEX_HULL || shape2 == Collider::CONVEX_HULL)
+        return convex_vs_convex(a_c, a_w, b_c, b_w, out);
     if (shape1 == Collider::SPHERE) {
         if (shape2 == Collider::SPHERE)
-            return sphere_vs_sphere(a_t, a_c, b_t, b_c, out);
+            return sphere_vs_sphere(a_c, a_w, b_c, b_w, out);
         if (shape2 == Collider::BOX)
-            return sphere_vs_box(a_t, a_c, b_t, b_c, out);
+            return sphere_vs_box(a_c, a_w, b_c, b_w, out);
         if (shape2 == Collider::CAPSULE)
-            return sphere_vs_capsule(a_t, a_c, b_t, b_c, out);
+            return sphere_vs_capsule(a_c, a_w, b_c, b_w, out);
     } else if (shape1 == Collider::BOX) {
         if (shape2 == Collider::SPHERE)
-            return sphere_vs_box(b_t, b_c, a_t, a_c, out);
+            return swapped(sphere_vs_box(b_c, b_w, a_c, a_w, out));
         if (shape2 == Collider::BOX)
-            return box_vs_box(a_t, a_c, b_t, b_c, out);
+            return box_vs_box(a_c, a_w, b_c, b_w, out);
         if (shape2 == Collider::CAPSULE)
-            return box_vs_capsule(a_t, a_c, b_t, b_c, out);
+            return box_vs_capsule(a_c, a_w, b_c, b_w, out);
     } else if (shape1 == Collider::CAPSULE) {
         if (shape2 == Collider::SPHERE)
-            return sphere_vs_capsule(b_t, b_c, a_t, a_c, out);
+            return swapped(sphere_vs_capsule(b_c, b_w, a_c, a_w, out));
         if (shape2 == Collider::BOX)
-            return box_vs_capsule(b_t, b_c, a_t, a_c, out);
+            return swapped(box_vs_capsule(b_c, b_w, a_c, a_w, out));
         if (shape2 == Collider::CAPSULE)
-            return capsule_vs_capsule(a_t, a_c, b_t, b_c, out);
+            return capsule_vs_capsule(a_c, a_w, b_c, b_w, out);
     }
     return false;
 }
 
-bool CollisionSystem::sphere_vs_sphere(const Transform &a_t, const Collider &a_c, const Transform &b_t,
-                                       const Collider &b_c, CollisionManifold &out) {
-    const glm::vec3 center_a    = a_t.position + a_c.offset;
-    const glm::vec3 center_b    = b_t.position + b_c.offset;
+bool CollisionSystem::sphere_vs_sphere(const Collider &a_c, const ColliderCache &a_w, const Collider &b_c,
+                                       const ColliderCache &b_w, CollisionManifold &out) {
+    const glm::vec3 center_a    = a_w.center;
+    const glm::vec3 center_b    = b_w.center;
     const glm::vec3 delta       = center_b - center_a;
     const float distance        = glm::length(delta);
     const float combined_radius = a_c.radius + b_c.radius;
@@ -169,18 +806,17 @@ bool CollisionSystem::sphere_vs_sphere(const Transform &a_t, const Collider &a_c
     return false;
 }
 
-bool CollisionSystem::sphere_vs_box(const Transform &sphere_t, const Collider &sphere_c, const Transform &box_t,
-                                    const Collider &box_c, CollisionManifold &out) {
+bool CollisionSystem::sphere_vs_box(const Collider &sphere_c, const ColliderCache &sphere_w, const Collider &box_c,
+                                    const ColliderCache &box_w, CollisionManifold &out) {
     // Transform sphere center to box's local space (including rotation and scaling)
-    const glm::mat4 inv_box       = glm::inverse(box_t.matrix());
-    const glm::vec3 sphere_world  = sphere_t.position + sphere_c.offset;
-    const glm::vec3 sphere_center = glm::vec3(inv_box * glm::vec4(sphere_world, 1.0f));
+    const glm::vec3 sphere_world  = sphere_w.center;
+    const glm::vec3 sphere_center = glm::vec3(box_w.inverse_matrix * glm::vec4(sphere_world, 1.0f));
     // Calculate the closest point in box's local space (axis-aligned clamp)
     const glm::vec3 closest_local = glm::clamp(sphere_center,
                                                -box_c.half_extents, // Should already include scale factors
                                                box_c.half_extents);
     // Convert the closest point back to world space
-    const glm::vec3 closest_world = box_t.matrix() * glm::vec4(closest_local, 1.0f);
+    const glm::vec3 closest_world = box_w.matrix * glm::vec4(closest_local, 1.0f);
     const glm::vec3 delta         = sphere_world - closest_world;
     const float distance          = glm::length(delta);
     const float radius            = sphere_c.radius;
@@ -200,7 +836,7 @@ bool CollisionSystem::sphere_vs_box(const Transform &sphere_t, const Collider &s
             } else {
                 box_local_normal.z = (sphere_center.z > 0) ? 1.0f : -1.0f;
             }
-            out.normal            = glm::normalize(box_t.matrix() * glm::vec4(box_local_normal, 0.0f));
+            out.normal            = glm::normalize(box_w.basis * box_local_normal);
             out.penetration_depth = radius + glm::length(closest_world - sphere_world);
         } else {
             out.normal            = glm::normalize(delta);
@@ -208,6 +844,8 @@ bool CollisionSystem::sphere_vs_box(const Transform &sphere_t, const Collider &s
         }
         // Calculate contact point on sphere surface
         out.contact_point = closest_world + out.normal * sphere_c.radius;
+        // Normal was computed from box to sphere; report it from sphere to box
+        out.normal = -out.normal;
         // Combine material properties
         out.combined_friction    = std::sqrt(sphere_c.friction * box_c.friction);
         out.combined_restitution = std::sqrt(sphere_c.restitution * box_c.restitution);
@@ -216,14 +854,14 @@ bool CollisionSystem::sphere_vs_box(const Transform &sphere_t, const Collider &s
     return false;
 }
 
-bool CollisionSystem::sphere_vs_capsule(const Transform &sphere_t, const Collider &sphere_c, const Transform &capsule_t,
-                                        const Collider &capsule_c, CollisionManifold &out) {
-    // Get capsule endpoints considering rotation and proper height calculation
-    glm::vec3 capsule_base, capsule_top;
-    get_capsule_endpoints(capsule_t, capsule_c, capsule_base, capsule_top);
+bool CollisionSystem::sphere_vs_capsule(const Collider &sphere_c, const ColliderCache &sphere_w,
+                                        const Collider &capsule_c, const ColliderCache &capsule_w,
+                                        CollisionManifold &out) {
+    const glm::vec3 &capsule_base = capsule_w.capsule_base;
+    const glm::vec3 &capsule_top  = capsule_w.capsule_top;
 
     // Sphere center in world space
-    const glm::vec3 sphere_center = sphere_t.position + sphere_c.offset;
+    const glm::vec3 sphere_center = sphere_w.center;
 
     // Find closest point on capsule's central segment
     const glm::vec3 closest     = closest_point_on_line_segment(sphere_center, capsule_base, capsule_top);
@@ -265,6 +903,8 @@ bool CollisionSystem::sphere_vs_capsule(const Transform &sphere_t, const Collide
         // Calculate contact point on capsule surface
         out.contact_point     = closest + out.normal * capsule_c.capsule_radius;
         out.penetration_depth = combined_radius - distance;
+        // Normal was computed from capsule to sphere; report it from sphere to capsule
+        out.normal = -out.normal;
 
         // Combine physical properties
         out.combined_friction    = std::sqrt(sphere_c.friction * capsule_c.friction);
@@ -274,21 +914,17 @@ bool CollisionSystem::sphere_vs_capsule(const Transform &sphere_t, const Collide
     return false;
 }
 
-bool CollisionSystem::box_vs_capsule(const Transform &box_t, const Collider &box_c, const Transform &capsule_t,
-                                     const Collider &capsule_c, CollisionManifold &out) {
-    // Calculate capsule endpoints with rotation
-    glm::vec3 capsule_base, capsule_top;
-    get_capsule_endpoints(capsule_t, capsule_c, capsule_base, capsule_top);
-    // Convert to box's local space
-    const glm::mat4 inv_box    = glm::inverse(box_t.matrix());
-    const glm::vec3 local_base = glm::vec3(inv_box * glm::vec4(capsule_base, 1.0f));
-    const glm::vec3 local_top  = glm::vec3(inv_box * glm::vec4(capsule_top, 1.0f));
+bool CollisionSystem::box_vs_capsule(const Collider &box_c, const ColliderCache &box_w, const Collider &capsule_c,
+                                     const ColliderCache &capsule_w, CollisionManifold &out) {
+    // Convert capsule segment to box's local space
+    const glm::vec3 local_base = glm::vec3(box_w.inverse_matrix * glm::vec4(capsule_w.capsule_base, 1.0f));
+    const glm::vec3 local_top  = glm::vec3(box_w.inverse_matrix * glm::vec4(capsule_w.capsule_top, 1.0f));
     // Find the closest point in box space
     const glm::vec3 local_closest = closest_point_on_line_segment(glm::vec3(0), local_base, local_top);
     const glm::vec3 box_closest   = glm::clamp(local_closest, -box_c.half_extents, box_c.half_extents);
     // Convert back to world space
-    const glm::vec3 world_box_closest     = box_t.matrix() * glm::vec4(box_closest, 1.0f);
-    const glm::vec3 world_capsule_closest = box_t.matrix() * glm::vec4(local_closest, 1.0f);
+    const glm::vec3 world_box_closest     = box_w.matrix * glm::vec4(box_closest, 1.0f);
+    const glm::vec3 world_capsule_closest = box_w.matrix * glm::vec4(local_closest, 1.0f);
     const glm::vec3 delta                 = world_capsule_closest - world_box_closest;
     const float dist                      = glm::length(delta);
 
@@ -303,27 +939,38 @@ bool CollisionSystem::box_vs_capsule(const Transform &box_t, const Collider &box
     return false;
 }
 
-bool CollisionSystem::capsule_vs_capsule(const Transform &a_t, const Collider &a_c, const Transform &b_t,
-                                         const Collider &b_c, CollisionManifold &out) {
-    // 胶囊A的端点
-    glm::vec3 a_base = a_t.position + a_c.offset;
-    glm::vec3 a_top  = a_base;
-    a_top.y += a_c.capsule_height;
-
-    // 胶囊B的端点
-    glm::vec3 b_base = b_t.position + b_c.offset;
-    glm::vec3 b_top  = b_base;
-    b_top.y += b_c.capsule_height;
-
+bool CollisionSystem::capsule_vs_capsule(const Collider &a_c, const ColliderCache &a_w, const Collider &b_c,
+                                         const ColliderCache &b_w, CollisionManifold &out) {
     // 计算最近点对
-    auto [closest_a, closest_b] = closest_points_between_lines(a_base, a_top, b_base, b_top);
+    auto [closest_a, closest_b] =
+        closest_points_between_lines(a_w.capsule_base, a_w.capsule_top, b_w.capsule_base, b_w.capsule_top);
 
     glm::vec3 delta       = closest_b - closest_a;
     float dist            = glm::length(delta);
     float combined_radius = a_c.capsule_radius + b_c.capsule_radius;
 
     if (dist < combined_radius) {
-        out.normal               = glm::normalize(delta);
+        constexpr float epsilon = 1e-6f;
+        if (dist > epsilon) {
+            out.normal = delta / dist;
+        } else {
+            // Crossing cores: separate along the normal of both segments, or perpendicular to A when parallel
+            const glm::vec3 axis_a = a_w.capsule_top - a_w.capsule_base;
+            const glm::vec3 axis_b = b_w.capsule_top - b_w.capsule_base;
+            glm::vec3 normal       = glm::cross(axis_a, axis_b);
+            if (glm::length(normal) <= epsilon) {
+                const glm::vec3 magnitude = glm::abs(axis_a);
+                const glm::vec3 least     = magnitude.x <= magnitude.y && magnitude.x <= magnitude.z
+                                                ? glm::vec3(1.0f, 0.0f, 0.0f)
+                                            : magnitude.y <= magnitude.z ? glm::vec3(0.0f, 1.0f, 0.0f)
+                                                                         : glm::vec3(0.0f, 0.0f, 1.0f);
+                normal = glm::cross(axis_a, least);
+            }
+            normal = glm::length(normal) > epsilon ? glm::normalize(normal) : glm::vec3(0.0f, 1.0f, 0.0f);
+            // Pointed from the middle of A towards the middle of B
+            const glm::vec3 middles = (b_w.capsule_base + b_w.capsule_top - a_w.capsule_base - a_w.capsule_top) * 0.5f;
+            out.normal              = glm::dot(normal, middles) < 0.0f ? -normal : normal;
+        }
         out.contact_point        = (closest_a + closest_b) * 0.5f;
         out.penetration_depth    = combined_radius - dist;
         out.combined_friction    = std::sqrt(a_c.friction * b_c.friction);
@@ -333,102 +980,347 @@ bool CollisionSystem::capsule_vs_capsule(const Transform &a_t, const Collider &a
     return false;
 }
 
-bool CollisionSystem::box_vs_box(const Transform &a_t, const Collider &a_c, const Transform &b_t, const Collider &b_c,
-                                 CollisionManifold &out) {
+template <typename Triangles>
+bool CollisionSystem::triangles_vs_convex(const Triangles &mesh, bool solid_below, const Collider &mesh_c,
+                                          const ColliderCache &mesh_w, const Collider &other_c,
+                                          const ColliderCache &other_w, CollisionManifold &out) {
+    const AABB bounds     = other_w.aabb.transformed(mesh_w.inverse_matrix);
+    bool hit              = false;
+    out.penetration_depth = 0.0f;
+    mesh.query(bounds.min, bounds.max, [&](uint32_t triangle) {
+        const auto local           = mesh.get_triangle(triangle);
+        const glm::vec3 corners[3] = { glm::vec3(mesh_w.matrix * glm::vec4(local[0], 1.0f)),
+                                       glm::vec3(mesh_w.matrix * glm::vec4(local[1], 1.0f)),
+                                       glm::vec3(mesh_w.matrix * glm::vec4(local[2], 1.0f)) };
+        glm::vec3 normal, point;
+        float depth;
+        if (other_c.shape == Collider::SPHERE || other_c.shape == Collider::CAPSULE) {
+            // Round shapes: distance from the core point or segment to the triangle
+            glm::vec3 core, on_triangle;
+            float radius;
+            if (other_c.shape == Collider::SPHERE) {
+                core        = other_w.center;
+                on_triangle = TriangleMeshBVH::closest_point_on_triangle(core, corners[0], corners[1], corners[2]);
+                radius      = other_c.radius;
+            } else {
+                std::tie(core, on_triangle) = closest_points_segment_triangle(
+                    other_w.capsule_base, other_w.capsule_top, corners[0], corners[1], corners[2]);
+                radius = other_c.capsule_radius;
+            }
+            const glm::vec3 delta = core - on_triangle;
+            const float distance  = glm::length(delta);
+            const glm::vec3 face  = glm::normalize(glm::cross(corners[1] - corners[0], corners[2] - corners[0]));
+            if (solid_below && glm::dot(delta, face) < -0.99f * distance) {
+                // Core sunk right below the face: push it back out through the face, not further down
+                normal = face;
+                point  = on_triangle;
+                depth  = radius + distance;
+            } else {
+                if (distance >= radius)
+                    return;
+                normal = distance > 1e-6f ? delta / distance : face;
+                point  = on_triangle;
+                depth  = radius - distance;
+            }
+        } else {
+            ConvexContact contact{};
+            if (!gjk_epa(ConvexShape{ &mesh_c, &mesh_w, 0, corners }, ConvexShape{ &other_c, &other_w }, contact))
+                return;
+            normal = contact.normal;
+            point  = contact.point;
+            depth  = contact.depth;
+        }
+        if (depth > out.penetration_depth) {
+            hit                   = true;
+            out.normal            = normal;
+            out.contact_point     = point;
+            out.penetration_depth = depth;
+            out.feature_id        = triangle;
+        }
+    });
+    if (!hit)
+        return false;
+    out.combined_friction    = std::sqrt(mesh_c.friction * other_c.friction);
+    out.combined_restitution = std::sqrt(mesh_c.restitution * other_c.restitution);
+    return true;
+}
+
+bool CollisionSystem::mesh_vs_convex(const Collider &mesh_c, const ColliderCache &mesh_w, const Collider &other_c,
+                                     const ColliderCache &other_w, CollisionManifold &out) {
+    if (!mesh_c.triangle_mesh || other_c.shape == Collider::TRIANGLE_MESH ||
+        (other_c.shape == Collider::CONVEX_HULL && !other_c.convex_hull))
+        return false;
+    return triangles_vs_convex(*mesh_c.triangle_mesh, false, mesh_c, mesh_w, other_c, other_w, out);
+}
+
+bool CollisionSystem::heightfield_vs_convex(const Collider &field_c, const ColliderCache &field_w,
+                                            const Collider &other_c, const ColliderCache &other_w,
+                                            CollisionManifold &out) {
+    if (!field_c.height_field || other_c.shape == Collider::HEIGHTFIELD || other_c.shape == Collider::SDF ||
+        other_c.shape == Collider::TRIANGLE_MESH || (other_c.shape == Collider::CONVEX_HULL && !other_c.convex_hull))
+        return false;
+    return triangles_vs_convex(*field_c.height_field, true, field_c, field_w, other_c, other_w, out);
+}
+
+bool CollisionSystem::compound_vs_shape(const Collider &compound_c, const ColliderCache &compound_w,
+                                        const Collider &other_c, const ColliderCache &other_w,
+                                        CollisionManifold &out) {
+    if (!compound_c.compound)
+        return false;
+    const auto &shape = *compound_c.compound;
+    // A plane has no finite box to query with, every child is tested against it
+    const AABB bounds = other_c.shape == Collider::PLANE ? shape.get_bounds()
+                                                         : other_w.aabb.transformed(compound_w.inverse_matrix);
+    bool hit = false;
+    ColliderCache child_w;
+    shape.query(bounds, [&](uint32_t child) {
+        shape.child_cache(compound_w, child, child_w);
+        if (!child_w.aabb.overlaps(other_w.aabb))
+            return;
+        CollisionManifold manifold{};
+        if (!collide(shape.get_children()[child].collider, child_w, other_c, other_w, manifold))
+            return;
+        if (hit && manifold.penetration_depth <= out.penetration_depth)
+            return;
+        hit            = true;
+        out            = manifold;
+        out.feature_id = manifold.feature_id * 0x9E3779B1u + child;
+    });
+    return hit;
+}
+
+bool CollisionSystem::plane_vs_convex(const Collider &plane_c, const ColliderCache &plane_w, const Collider &other_c,
+                                      const ColliderCache &other_w, CollisionManifold &out) {
+    const glm::vec3 normal = plane_w.basis[1];
+    glm::vec3 deepest;
+    out.feature_id = 0;
+    switch (other_c.shape) {
+        case Collider::SPHERE:
+            deepest = other_w.center - normal * other_c.radius;
+            break;
+        case Collider::CAPSULE: {
+            const bool base_lower = glm::dot(other_w.capsule_base - other_w.capsule_top, normal) < 0.0f;
+            deepest = (base_lower ? other_w.capsule_base : other_w.capsule_top) - normal * other_c.capsule_radius;
+            break;
+        }
+        case Collider::BOX: {
+            // Corner furthest along -normal, its sign bits tell resting corners apart for warm starting
+            glm::vec3 corner;
+            for (int i = 0; i < 3; ++i) {
+                const bool positive = glm::dot(glm::vec3(other_w.matrix[i]), normal) < 0.0f;
+                corner[i]           = positive ? other_c.half_extents[i] : -other_c.half_extents[i];
+                out.feature_id |= positive ? 1u << i : 0u;
+            }
+            deepest = glm::vec3(other_w.matrix * glm::vec4(corner, 1.0f));
+            break;
+        }
+        case Collider::CONVEX_HULL: {
+            if (!other_c.convex_hull)
+                return false;
+            const ConvexShape hull{ &other_c, &other_w };
+            deepest = hull.support(-normal);
+            break;
+        }
+        default:
+            return false;
+    }
+    const float depth = glm::dot(plane_w.center - deepest, normal);
+    if (depth <= 0.0f)
+        return false;
+    out.normal               = normal;
+    out.contact_point        = deepest + normal * depth;
+    out.penetration_depth    = depth;
+    out.combined_friction    = std::sqrt(plane_c.friction * other_c.friction);
+    out.combined_restitution = std::sqrt(plane_c.restitution * other_c.restitution);
+    return true;
+}
+
+bool CollisionSystem::sdf_vs_convex(const Collider &sdf_c, const ColliderCache &sdf_w, const Collider &other_c,
+                                    const ColliderCache &other_w, CollisionManifold &out) {
+    if (!sdf_c.signed_distance_field || other_c.shape == Collider::SDF || other_c.shape == Collider::TRIANGLE_MESH ||
+        (other_c.shape == Collider::CONVEX_HULL && !other_c.convex_hull))
+        return false;
+    const auto &field        = *sdf_c.signed_distance_field;
+    const glm::mat3 to_world = glm::transpose(glm::mat3(sdf_w.inverse_matrix));
+    float radius             = 0.0f;
+    bool hit                 = false;
+    out.penetration_depth    = 0.0f;
+    auto test                = [&](const glm::vec3 &point) {
+        glm::vec3 gradient;
+        const float local_distance = field.sample(glm::vec3(sdf_w.inverse_matrix * glm::vec4(point, 1.0f)), gradient);
+        const float gradient_norm  = glm::length(gradient);
+        if (gradient_norm < 1e-6f)
+            return;
+        // The field is baked in model space, rescale the distance by the transform's stretch along the gradient
+        const glm::vec3 world_gradient = to_world * gradient;
+        const float distance           = local_distance * gradient_norm / glm::length(world_gradient);
+        const float depth              = radius - distance;
+        if (depth <= out.penetration_depth)
+            return;
+        hit                   = true;
+        out.normal            = glm::normalize(world_gradient);
+        out.contact_point     = point - out.normal * distance;
+        out.penetration_depth = depth;
+    };
+    switch (other_c.shape) {
+        case Collider::SPHERE:
+            radius = other_c.radius;
+            test(other_w.center);
+            break;
+        case Collider::CAPSULE: {
+            // Samples no further apart than the radius
+            radius               = other_c.capsule_radius;
+            const glm::vec3 axis = other_w.capsule_top - other_w.capsule_base;
+            const int steps      = std::max(static_cast<int>(std::ceil(glm::length(axis) / std::max(radius, 1e-3f))), 1);
+            for (int i = 0; i <= steps; ++i)
+                test(other_w.capsule_base + axis * (static_cast<float>(i) / static_cast<float>(steps)));
+            break;
+        }
+        case Collider::BOX:
+            for (int i = 0; i < 8; ++i) {
+                const glm::vec3 corner((i & 1 ? 1.0f : -1.0f) * other_c.half_extents.x,
+                                       (i & 2 ? 1.0f : -1.0f) * other_c.half_extents.y,
+                                       (i & 4 ? 1.0f : -1.0f) * other_c.half_extents.z);
+                test(glm::vec3(other_w.matrix * glm::vec4(corner, 1.0f)));
+            }
+            break;
+        case Collider::CONVEX_HULL:
+            for (const auto &vertex : other_c.convex_hull->get_vertices())
+                test(glm::vec3(other_w.matrix * glm::vec4(vertex, 1.0f)));
+            break;
+        default:
+            break;
+    }
+    if (!hit)
+        return false;
+    out.combined_friction    = std::sqrt(sdf_c.friction * other_c.friction);
+    out.combined_restitution = std::sqrt(sdf_c.restitution * other_c.restitution);
+    return true;
+}
+
+bool CollisionSystem::convex_vs_convex(const Collider &a_c, const ColliderCache &a_w, const Collider &b_c,
+                                       const ColliderCache &b_w, CollisionManifold &out) {
+    if ((a_c.shape == Collider::CONVEX_HULL && !a_c.convex_hull) ||
+        (b_c.shape == Collider::CONVEX_HULL && !b_c.convex_hull))
+        return false;
+    const ConvexShape shape_a{ &a_c, &a_w };
+    const ConvexShape shape_b{ &b_c, &b_w };
+    ConvexContact contact{};
+    if (!gjk_epa(shape_a, shape_b, contact))
+        return false;
+    out.normal               = contact.normal;
+    out.contact_point        = contact.point;
+    out.penetration_depth    = contact.depth;
+    out.combined_friction    = std::sqrt(a_c.friction * b_c.friction);
+    out.combined_restitution = std::sqrt(a_c.restitution * b_c.restitution);
+    return true;
+}
+
+bool CollisionSystem::box_vs_box(const Collider &a_c, const ColliderCache &a_w, const Collider &b_c,
+                                 const ColliderCache &b_w, CollisionManifold &out, uint32_t *axis_hint) {
     // Transform to A's local space
-    glm::mat4 a_inv  = glm::inverse(a_t.matrix());
-    glm::mat4 b_to_a = a_inv * b_t.matrix();
+    glm::mat4 b_to_a = a_w.inverse_matrix * b_w.matrix;
     glm::mat3 b_rot(b_to_a);
 
     // Get box centers and extents
-    glm::vec3 a_center  = a_c.offset;
+    glm::vec3 a_center(0.0f);
     auto b_center       = glm::vec3(b_to_a[3]);
     glm::vec3 a_extents = a_c.half_extents;
     glm::vec3 b_extents = b_c.half_extents;
+    glm::vec3 delta     = b_center - a_center;
+
+    // Overlap of both boxes along one of the 15 axes (0-2: A faces, 3-5: B faces, 6-14: edge pairs), negative if
+    // the axis separates them and FLT_MAX for degenerate edge pairs
+    constexpr float epsilon = 1e-6f;
+    auto test_axis          = [&](uint32_t index, glm::vec3 &normal) {
+        if (index < 3) {
+            // Calculate B's projection radius on A's axis
+            const uint32_t i   = index;
+            const float b_proj = b_extents.x * std::abs(b_rot[0][i]) + b_extents.y * std::abs(b_rot[1][i]) +
+                                 b_extents.z * std::abs(b_rot[2][i]);
+            normal    = glm::vec3(0);
+            normal[i] = delta[i] > 0 ? 1 : -1;
+            return a_extents[i] + b_proj - std::abs(delta[i]);
+        }
+        if (index < 6) {
+            const uint32_t i     = index - 3;
+            const glm::vec3 axis = glm::normalize(glm::vec3(b_rot[i]));
+            const float a_proj =
+                a_extents.x * std::abs(axis.x) + a_extents.y * std::abs(axis.y) + a_extents.z * std::abs(axis.z);
+            normal = axis * (glm::dot(delta, axis) > 0 ? 1.0f : -1.0f);
+            return a_proj + b_extents[i] - std::abs(glm::dot(delta, axis));
+        }
+        glm::vec3 axis_a(0);
+        axis_a[(index - 6) / 3] = 1.0f;
+        const auto axis_b       = glm::vec3(b_rot[(index - 6) % 3]);
+        glm::vec3 cross_axis    = glm::cross(axis_a, axis_b);
+        const float length      = glm::length(cross_axis);
+        if (length < epsilon)
+            return FLT_MAX;
+        cross_axis /= length;
+        const float a_proj = a_extents.x * std::abs(cross_axis.x) + a_extents.y * std::abs(cross_axis.y) +
+                             a_extents.z * std::abs(cross_axis.z);
+        const float b_proj = b_extents.x * std::abs(glm::dot(b_rot[0], cross_axis)) +
+                             b_extents.y * std::abs(glm::dot(b_rot[1], cross_axis)) +
+                             b_extents.z * std::abs(glm::dot(b_rot[2], cross_axis));
+        normal = cross_axis * (glm::dot(delta, cross_axis) > 0 ? 1.0f : -1.0f);
+        return a_proj + b_proj - std::abs(glm::dot(delta, cross_axis));
+    };
+
+    // Boxes that were apart last step usually still are along the same axis, which costs a single test
+    constexpr uint32_t axis_count = 15;
+    const bool has_hint           = axis_hint && *axis_hint < axis_count;
+    glm::vec3 hint_normal(0.0f);
+    const float hint_overlap = has_hint ? test_axis(*axis_hint, hint_normal) : FLT_MAX;
+    if (hint_overlap < 0)
+        return false;
 
     float penetration = FLT_MAX;
     glm::vec3 best_normal;
-    glm::vec3 delta = b_center - a_center;
-
-    // Test A's local axes
-    for (int i = 0; i < 3; ++i) {
-        // Calculate B's projection radius on A's axis
-        float b_proj = b_extents.x * std::abs(b_rot[0][i]) + b_extents.y * std::abs(b_rot[1][i]) +
-                       b_extents.z * std::abs(b_rot[2][i]);
-
-        float a_proj   = a_extents[i];
-        float distance = std::abs(delta[i]);
-        float overlap  = a_proj + b_proj - distance;
-
-        if (overlap < 0)
+    uint32_t best_axis = 0;
+    for (uint32_t axis = 0; axis < axis_count; ++axis) {
+        glm::vec3 normal;
+        const float overlap = has_hint && axis == *axis_hint ? hint_overlap : test_axis(axis, normal);
+        if (overlap < 0) {
+            if (axis_hint)
+                *axis_hint = axis;
             return false;
-        if (overlap < penetration) {
-            penetration    = overlap;
-            best_normal    = glm::vec3(0);
-            best_normal[i] = delta[i] > 0 ? 1 : -1;
         }
-    }
-
-    // Test B's local axes
-    for (int i = 0; i < 3; ++i) {
-        glm::vec3 axis = glm::normalize(glm::vec3(b_rot[i]));
-        float proj_a = a_extents.x * std::abs(axis.x) + a_extents.y * std::abs(axis.y) + a_extents.z * std::abs(axis.z);
-        float proj_b = b_extents[i];
-        float distance = std::abs(glm::dot(delta, axis));
-        float overlap  = proj_a + proj_b - distance;
-
-        if (overlap < 0)
-            return false;
         if (overlap < penetration) {
             penetration = overlap;
-            best_normal = axis * (glm::dot(delta, axis) > 0 ? 1.0f : -1.0f);
+            best_normal = has_hint && axis == *axis_hint ? hint_normal : normal;
+            best_axis   = axis;
         }
     }
-
-    // Test edge cross products
-    constexpr float epsilon = 1e-6f;
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
-            glm::vec3 axis_a(0);
-            axis_a[i]   = 1.0f;
-            auto axis_b = glm::vec3(b_rot[j]);
-
-            glm::vec3 cross_axis = glm::cross(axis_a, axis_b);
-            float length         = glm::length(cross_axis);
-            if (length < epsilon)
-                continue;
-
-            cross_axis /= length;
-            float a_proj = a_extents.x * std::abs(cross_axis.x) + a_extents.y * std::abs(cross_axis.y) +
-                           a_extents.z * std::abs(cross_axis.z);
-
-            float b_proj = b_extents.x * std::abs(glm::dot(b_rot[0], cross_axis)) +
-                           b_extents.y * std::abs(glm::dot(b_rot[1], cross_axis)) +
-                           b_extents.z * std::abs(glm::dot(b_rot[2], cross_axis));
-
-            float distance = std::abs(glm::dot(delta, cross_axis));
-            float overlap  = a_proj + b_proj - distance;
-
-            if (overlap < 0)
-                return false;
-            if (overlap < penetration) {
-                penetration = overlap;
-                best_normal = cross_axis * (glm::dot(delta, cross_axis) > 0 ? 1.0f : -1.0f);
-            }
-        }
+    // Keep last step's axis unless another one is clearly shallower, so resting boxes keep their contact feature
+    // instead of flickering between nearly equal axes. The absolute slack follows the size of the smaller box, 0.005
+    // for unit cubes, so small boxes still switch axes and large ones still hold theirs
+    constexpr float relative_tolerance = 1.02f;
+    constexpr float size_tolerance     = 0.01f;
+    const float smallest_extent        = std::min(std::min(std::min(a_extents.x, a_extents.y), a_extents.z),
+                                                  std::min(std::min(b_extents.x, b_extents.y), b_extents.z));
+    const float absolute_tolerance     = size_tolerance * smallest_extent;
+    if (has_hint && hint_overlap < FLT_MAX &&
+        hint_overlap <= penetration * relative_tolerance + absolute_tolerance) {
+        penetration = hint_overlap;
+        best_normal = hint_normal;
+        best_axis   = *axis_hint;
     }
+    if (axis_hint)
+        *axis_hint = best_axis;
 
     // Calculate final collision data
     if (penetration < FLT_MAX) {
         // Transform normal to world space
-        best_normal = glm::normalize(glm::vec3(a_t.matrix() * glm::vec4(best_normal, 0.0f)));
+        best_normal = glm::normalize(glm::vec3(a_w.matrix * glm::vec4(best_normal, 0.0f)));
 
         // Calculate contact point (improved approximation)
-        glm::vec3 a_world_center = a_t.position + a_c.offset;
-        glm::vec3 b_world_center = b_t.position + b_c.offset;
+        glm::vec3 a_world_center = a_w.center;
+        glm::vec3 b_world_center = b_w.center;
         out.contact_point        = a_world_center + (b_world_center - a_world_center) * 0.5f;
 
         out.normal               = best_normal;
+        out.feature_id           = best_axis;
         out.penetration_depth    = penetration;
         out.combined_friction    = std::sqrt(a_c.friction * b_c.friction);
         out.combined_restitution = std::sqrt(a_c.restitution * b_c.restitution);
@@ -438,6 +1330,39 @@ bool CollisionSystem::box_vs_box(const Transform &a_t, const Collider &a_c, cons
     return false;
 }
 
+std::pair<glm::vec3, glm::vec3> CollisionSystem::closest_points_segment_triangle(const glm::vec3 &p0,
+                                                                                 const glm::vec3 &p1,
+                                                                                 const glm::vec3 &a, const glm::vec3 &b,
+                                                                                 const glm::vec3 &c) {
+    // A segment piercing the triangle touches it at the crossing point
+    const glm::vec3 normal = glm::cross(b - a, c - a);
+    const float s0         = glm::dot(p0 - a, normal), s1 = glm::dot(p1 - a, normal);
+    if ((s0 <= 0.0f && s1 >= 0.0f) || (s0 >= 0.0f && s1 <= 0.0f)) {
+        if (s0 != s1) {
+            const glm::vec3 crossing = p0 + (p1 - p0) * (s0 / (s0 - s1));
+            const glm::vec3 on_face  = TriangleMeshBVH::closest_point_on_triangle(crossing, a, b, c);
+            if (glm::dot(crossing - on_face, crossing - on_face) < 1e-10f)
+                return { crossing, on_face };
+        }
+    }
+    // Otherwise the closest pair involves a segment end point or a triangle edge
+    std::pair<glm::vec3, glm::vec3> best = { p0, TriangleMeshBVH::closest_point_on_triangle(p0, a, b, c) };
+    float best_distance                  = glm::dot(best.first - best.second, best.first - best.second);
+
+    auto consider = [&](const std::pair<glm::vec3, glm::vec3> &candidate) {
+        const float distance = glm::dot(candidate.first - candidate.second, candidate.first - candidate.second);
+        if (distance < best_distance) {
+            best_distance = distance;
+            best          = candidate;
+        }
+    };
+    consider({ p1, TriangleMeshBVH::closest_point_on_triangle(p1, a, b, c) });
+    consider(closest_points_between_lines(p0, p1, a, b));
+    consider(closest_points_between_lines(p0, p1, b, c));
+    consider(closest_points_between_lines(p0, p1, c, a));
+    return best;
+}
+
 glm::vec3 CollisionSystem::closest_point_on_line_segment(const glm::vec3 &point, const glm::vec3 &a,
                                                          const glm::vec3 &b) {
     glm::vec3 ab = b - a;
@@ -539,19 +1464,3 @@ std::pair<glm::vec3, glm::vec3> CollisionSystem::closest_points_between_lines(co
         return { a1 + s * d1, b1 + t * d2 };
     }
 }
-
-void CollisionSystem::get_capsule_endpoints(const Transform &t, const Collider &c, glm::vec3 &base, glm::vec3 &top) {
-    // Calculate capsule center in world space
-    const glm::vec3 center = t.position + c.offset;
-
-    // Get orientation and calculate capsule direction
-    const glm::vec3 world_up = t.orientation() * glm::vec3(0, 1, 0);
-
-    // Calculate actual cylinder height (total_height - 2*radius)
-    const float cylinder_height = glm::max(c.capsule_height - 2 * c.capsule_radius, 0.0f);
-    const float half_cylinder   = cylinder_height * 0.5f;
-
-    // Calculate endpoints relative to center
-    base = center - world_up * half_cylinder;
-    top  = center + world_up * half_cylinder;
-}
@@ -0,0 +1,16 @@
+#include <ecs/system/physics_subsystem/contact_events.h>
+
+std::span<const ContactEvent> ContactEvents::get_events(size_t age) const {
+    if (age >= frame_count || age >= m_frame)
+        return {};
+    return m_frames[(m_frame - 1 - age) % frame_count];
+}
+
+uint64_t ContactEvents::get_frame() const noexcept { return m_frame; }
+
+void ContactEvents::begin_frame() {
+    m_frames[m_frame % frame_count].clear();
+    ++m_frame;
+}
+
+void ContactEvents::push(const ContactEvent &event) { m_frames[(m_frame - 1) % frame_count].push_back(event); }
@@ -0,0 +1,158 @@
+#include <bit>
+#include <cmath>
+#include <ecs/system/physics_subsystem/narrowphase/batch_kernels.h>
+
+// Every lane computes both sides of each choice and blends them through a bit mask. A ?: or std::min on floats is
+// kept as a branch by the compiler, which stops it from vectorizing the whole loop. Results go to a local batch
+// copied out at the end, the compiler cannot rule out that out overlaps the inputs.
+namespace {
+constexpr float epsilon = 1e-6f;
+
+inline float select(bool mask, float if_true, float if_false) {
+    const uint32_t bits = 0u - static_cast<uint32_t>(mask);
+    return std::bit_cast<float>((std::bit_cast<uint32_t>(if_true) & bits) |
+                                (std::bit_cast<uint32_t>(if_false) & ~bits));
+}
+
+// Picks x, y or z of the first true mask
+inline float select(bool use_x, bool use_y, float x, float y, float z) { return select(use_x, x, select(use_y, y, z)); }
+
+inline float minimum(float a, float b) { return select(a < b, a, b); }
+
+inline float maximum(float a, float b) { return select(a > b, a, b); }
+
+inline float clamp(float value, float low, float high) { return minimum(maximum(value, low), high); }
+
+inline float safe_inverse(float value) { return select(value > epsilon, 1.0f / maximum(value, epsilon), 0.0f); }
+} // namespace
+
+void collide_sphere_sphere(const SphereLanes &a, const SphereLanes &b, ContactLanes &out) {
+    ContactLanes result;
+    for (size_t i = 0; i < batch_width; ++i) {
+        const float dx              = b.x[i] - a.x[i];
+        const float dy              = b.y[i] - a.y[i];
+        const float dz              = b.z[i] - a.z[i];
+        const float distance        = std::sqrt(dx * dx + dy * dy + dz * dz);
+        const float combined_radius = a.radius[i] + b.radius[i];
+        const float inv_distance    = safe_inverse(distance);
+        result.normal_x[i]          = dx * inv_distance;
+        result.normal_y[i]          = dy * inv_distance;
+        result.normal_z[i]          = dz * inv_distance;
+        result.point_x[i]           = a.x[i] + result.normal_x[i] * a.radius[i];
+        result.point_y[i]           = a.y[i] + result.normal_y[i] * a.radius[i];
+        result.point_z[i]           = a.z[i] + result.normal_z[i] * a.radius[i];
+        result.depth[i]             = combined_radius - distance;
+        result.hit[i]               = (distance < combined_radius) & (distance > epsilon);
+    }
+    out = result;
+}
+
+void collide_sphere_box(const SphereLanes &sphere, const BoxLanes &box, ContactLanes &out) {
+    const auto &m   = box.matrix;
+    const auto &inv = box.inverse;
+    ContactLanes result;
+    for (size_t i = 0; i < batch_width; ++i) {
+        // Sphere center in box space
+        const float sx = sphere.x[i], sy = sphere.y[i], sz = sphere.z[i];
+        const float lx = inv[0][i] * sx + inv[3][i] * sy + inv[6][i] * sz + inv[9][i];
+        const float ly = inv[1][i] * sx + inv[4][i] * sy + inv[7][i] * sz + inv[10][i];
+        const float lz = inv[2][i] * sx + inv[5][i] * sy + inv[8][i] * sz + inv[11][i];
+        // Closest point on the box, back in world space
+        const float cx       = clamp(lx, -box.half_x[i], box.half_x[i]);
+        const float cy       = clamp(ly, -box.half_y[i], box.half_y[i]);
+        const float cz       = clamp(lz, -box.half_z[i], box.half_z[i]);
+        const float wx       = m[0][i] * cx + m[3][i] * cy + m[6][i] * cz + m[9][i];
+        const float wy       = m[1][i] * cx + m[4][i] * cy + m[7][i] * cz + m[10][i];
+        const float wz       = m[2][i] * cx + m[5][i] * cy + m[8][i] * cz + m[11][i];
+        const float dx       = sx - wx;
+        const float dy       = sy - wy;
+        const float dz       = sz - wz;
+        const float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+        const float radius   = sphere.radius[i];
+        // Center inside the box: push out along the box axis of least penetration
+        const float px         = box.half_x[i] - std::fabs(lx);
+        const float py         = box.half_y[i] - std::fabs(ly);
+        const float pz         = box.half_z[i] - std::fabs(lz);
+        const bool use_x       = (px < py) & (px < pz);
+        const bool use_y       = !use_x & (py < pz);
+        const float sign       = select(select(use_x, use_y, lx, ly, lz) > 0.0f, 1.0f, -1.0f);
+        const float ax         = select(use_x, use_y, m[0][i], m[3][i], m[6][i]);
+        const float ay         = select(use_x, use_y, m[1][i], m[4][i], m[7][i]);
+        const float az         = select(use_x, use_y, m[2][i], m[5][i], m[8][i]);
+        const float axis_scale = sign * safe_inverse(std::sqrt(ax * ax + ay * ay + az * az));
+        // Normal from box to sphere, either case
+        const bool inside        = distance < epsilon;
+        const float inv_distance = safe_inverse(distance);
+        const float nx           = select(inside, ax * axis_scale, dx * inv_distance);
+        const float ny           = select(inside, ay * axis_scale, dy * inv_distance);
+        const float nz           = select(inside, az * axis_scale, dz * inv_distance);
+        result.point_x[i]        = wx + nx * radius;
+        result.point_y[i]        = wy + ny * radius;
+        result.point_z[i]        = wz + nz * radius;
+        result.normal_x[i]       = -nx;
+        result.normal_y[i]       = -ny;
+        result.normal_z[i]       = -nz;
+        result.depth[i]          = select(inside, radius + distance, radius - distance);
+        result.hit[i]            = distance < radius;
+    }
+    out = result;
+}
+
+void collide_capsule_capsule(const CapsuleLanes &a, const CapsuleLanes &b, ContactLanes &out) {
+    ContactLanes result;
+    for (size_t i = 0; i < batch_width; ++i) {
+        // Closest points between the two core segments
+        const float d1x   = a.top_x[i] - a.base_x[i], d1y = a.top_y[i] - a.base_y[i], d1z = a.top_z[i] - a.base_z[i];
+        const float d2x   = b.top_x[i] - b.base_x[i], d2y = b.top_y[i] - b.base_y[i], d2z = b.top_z[i] - b.base_z[i];
+        const float rx    = a.base_x[i] - b.base_x[i], ry = a.base_y[i] - b.base_y[i], rz = a.base_z[i] - b.base_z[i];
+        const float aa    = d1x * d1x + d1y * d1y + d1z * d1z;
+        const float bb    = d1x * d2x + d1y * d2y + d1z * d2z;
+        const float cc    = d2x * d2x + d2y * d2y + d2z * d2z;
+        const float dd    = d1x * rx + d1y * ry + d1z * rz;
+        const float ee    = d2x * rx + d2y * ry + d2z * rz;
+        const float denom = aa * cc - bb * bb;
+        // Parallel segments start from s = 0, any point of the overlap is a valid closest pair
+        const float s_free          = clamp((bb * ee - cc * dd) / maximum(denom, epsilon), 0.0f, 1.0f);
+        const float s0              = select(denom < epsilon, 0.0f, s_free);
+        const float t               = clamp((bb * s0 + ee) * safe_inverse(cc), 0.0f, 1.0f);
+        const float s               = clamp((bb * t - dd) * safe_inverse(aa), 0.0f, 1.0f);
+        const float pax             = a.base_x[i] + s * d1x, pay = a.base_y[i] + s * d1y, paz = a.base_z[i] + s * d1z;
+        const float pbx             = b.base_x[i] + t * d2x, pby = b.base_y[i] + t * d2y, pbz = b.base_z[i] + t * d2z;
+        const float dx              = pbx - pax, dy = pby - pay, dz = pbz - paz;
+        const float distance        = std::sqrt(dx * dx + dy * dy + dz * dz);
+        const float combined_radius = a.radius[i] + b.radius[i];
+        // Crossing cores leave no direction between the closest points: separate along the normal of both
+        // segments, or along any direction perpendicular to segment A when they are parallel
+        const float cx        = d1y * d2z - d1z * d2y, cy = d1z * d2x - d1x * d2z, cz = d1x * d2y - d1y * d2x;
+        const float cross_len = std::sqrt(cx * cx + cy * cy + cz * cz);
+        const float ad1x      = std::fabs(d1x), ad1y = std::fabs(d1y), ad1z = std::fabs(d1z);
+        const bool perp_x     = (ad1x <= ad1y) & (ad1x <= ad1z);
+        const bool perp_y     = !perp_x & (ad1y <= ad1z);
+        const float qx        = select(perp_x, perp_y, 0.0f, -d1z, d1y);
+        const float qy        = select(perp_x, perp_y, d1z, 0.0f, -d1x);
+        const float qz        = select(perp_x, perp_y, -d1y, d1x, 0.0f);
+        const float perp_len  = std::sqrt(qx * qx + qy * qy + qz * qz);
+        const bool use_cross  = cross_len > epsilon;
+        const bool use_perp   = !use_cross & (perp_len > epsilon);
+        const float fallback  = select(use_cross, use_perp, safe_inverse(cross_len), safe_inverse(perp_len), 1.0f);
+        const float fx        = select(use_cross, use_perp, cx, qx, 0.0f) * fallback;
+        const float fy        = select(use_cross, use_perp, cy, qy, 1.0f) * fallback;
+        const float fz        = select(use_cross, use_perp, cz, qz, 0.0f) * fallback;
+        // Pointed from the middle of A towards the middle of B, like the regular normal
+        const float mx           = (b.base_x[i] + b.top_x[i] - a.base_x[i] - a.top_x[i]) * 0.5f;
+        const float my           = (b.base_y[i] + b.top_y[i] - a.base_y[i] - a.top_y[i]) * 0.5f;
+        const float mz           = (b.base_z[i] + b.top_z[i] - a.base_z[i] - a.top_z[i]) * 0.5f;
+        const float side         = select(fx * mx + fy * my + fz * mz < 0.0f, -1.0f, 1.0f);
+        const bool crossing      = distance <= epsilon;
+        const float inv_distance = safe_inverse(distance);
+        result.normal_x[i]       = select(crossing, fx * side, dx * inv_distance);
+        result.normal_y[i]       = select(crossing, fy * side, dy * inv_distance);
+        result.normal_z[i]       = select(crossing, fz * side, dz * inv_distance);
+        result.point_x[i]        = (pax + pbx) * 0.5f;
+        result.point_y[i]        = (pay + pby) * 0.5f;
+        result.point_z[i]        = (paz + pbz) * 0.5f;
+        result.depth[i]          = select(crossing, combined_radius, combined_radius - distance);
+        result.hit[i]            = distance < combined_radius;
+    }
+    out = result;
+}
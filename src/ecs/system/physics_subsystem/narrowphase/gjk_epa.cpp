@@ -0,0 +1,295 @@
+#include <algorithm>
+#include <cfloat>
+#include <ecs/system/physics_subsystem/narrowphase/gjk_epa.h>
+#include <initializer_list>
+#include <scene/model/convex_hull.h>
+#include <vector>
+
+namespace {
+constexpr int max_gjk_iterations = 64;
+constexpr int max_epa_iterations = 64;
+constexpr float epa_tolerance    = 1e-4f;
+
+/**
+ * @brief Vertex of the Minkowski difference a - b, remembering the point on a for the contact position
+ */
+struct SupportPoint {
+    glm::vec3 w;
+    glm::vec3 a;
+};
+
+SupportPoint minkowski_support(const ConvexShape &a, const ConvexShape &b, const glm::vec3 &direction) {
+    const glm::vec3 point_a = a.support(direction);
+    return { point_a - b.support(-direction), point_a };
+}
+
+bool same_direction(const glm::vec3 &a, const glm::vec3 &b) { return glm::dot(a, b) > 0.0f; }
+
+/**
+ * @brief Simplex with the newest point first
+ */
+struct Simplex {
+    SupportPoint points[4];
+    int size = 0;
+
+    void push_front(const SupportPoint &point) {
+        for (int i = std::min(size, 3); i > 0; --i)
+            points[i] = points[i - 1];
+        points[0] = point;
+        size      = std::min(size + 1, 4);
+    }
+
+    void assign(std::initializer_list<SupportPoint> list) {
+        size = 0;
+        for (const auto &point : list)
+            points[size++] = point;
+    }
+};
+
+bool line_case(Simplex &simplex, glm::vec3 &direction) {
+    const auto a = simplex.points[0], b = simplex.points[1];
+    const glm::vec3 ab = b.w - a.w, ao = -a.w;
+    if (same_direction(ab, ao)) {
+        const glm::vec3 perpendicular = glm::cross(ab, ao);
+        // Origin on the segment's line: every direction normal to it is as good
+        if (glm::dot(perpendicular, perpendicular) <= FLT_EPSILON * glm::dot(ab, ab) * glm::dot(ao, ao))
+            direction = glm::cross(ab, std::abs(ab.x) > 0.57735f ? glm::vec3(0, 1, 0) : glm::vec3(1, 0, 0));
+        else
+            direction = glm::cross(perpendicular, ab);
+    } else {
+        simplex.assign({ a });
+        direction = ao;
+    }
+    return false;
+}
+
+bool triangle_case(Simplex &simplex, glm::vec3 &direction) {
+    const auto a = simplex.points[0], b = simplex.points[1], c = simplex.points[2];
+    const glm::vec3 ab = b.w - a.w, ac = c.w - a.w, ao = -a.w;
+    const glm::vec3 abc = glm::cross(ab, ac);
+    if (same_direction(glm::cross(abc, ac), ao)) {
+        if (same_direction(ac, ao)) {
+            simplex.assign({ a, c });
+            direction = glm::cross(glm::cross(ac, ao), ac);
+            return false;
+        }
+        simplex.assign({ a, b });
+        return line_case(simplex, direction);
+    }
+    if (same_direction(glm::cross(ab, abc), ao)) {
+        simplex.assign({ a, b });
+        return line_case(simplex, direction);
+    }
+    if (same_direction(abc, ao)) {
+        direction = abc;
+    } else {
+        simplex.assign({ a, c, b });
+        direction = -abc;
+    }
+    return false;
+}
+
+bool tetrahedron_case(Simplex &simplex, glm::vec3 &direction) {
+    const auto a = simplex.points[0], b = simplex.points[1], c = simplex.points[2], d = simplex.points[3];
+    const glm::vec3 ab = b.w - a.w, ac = c.w - a.w, ad = d.w - a.w, ao = -a.w;
+    if (same_direction(glm::cross(ab, ac), ao)) {
+        simplex.assign({ a, b, c });
+        return triangle_case(simplex, direction);
+    }
+    if (same_direction(glm::cross(ac, ad), ao)) {
+        simplex.assign({ a, c, d });
+        return triangle_case(simplex, direction);
+    }
+    if (same_direction(glm::cross(ad, ab), ao)) {
+        simplex.assign({ a, d, b });
+        return triangle_case(simplex, direction);
+    }
+    return true;
+}
+
+/**
+ * @brief Reduce the simplex to the feature closest to the origin and pick the next search direction
+ * @return true once the simplex encloses the origin
+ */
+bool next_simplex(Simplex &simplex, glm::vec3 &direction) {
+    switch (simplex.size) {
+        case 2:
+            return line_case(simplex, direction);
+        case 3:
+            return triangle_case(simplex, direction);
+        case 4:
+            return tetrahedron_case(simplex, direction);
+        default:
+            return false;
+    }
+}
+
+bool gjk(const ConvexShape &a, const ConvexShape &b, Simplex &simplex) {
+    glm::vec3 direction = a.center() - b.center();
+    if (glm::dot(direction, direction) < FLT_EPSILON)
+        direction = glm::vec3(1.0f, 0.0f, 0.0f);
+    simplex.assign({ minkowski_support(a, b, direction) });
+    direction = -simplex.points[0].w;
+    for (int i = 0; i < max_gjk_iterations; ++i) {
+        // The origin lies on the simplex: the shapes only touch
+        if (glm::dot(direction, direction) < FLT_EPSILON)
+            return false;
+        const SupportPoint point = minkowski_support(a, b, direction);
+        if (glm::dot(point.w, direction) <= 0.0f)
+            return false;
+        simplex.push_front(point);
+        if (next_simplex(simplex, direction))
+            return true;
+    }
+    return false;
+}
+
+struct EpaFace {
+    uint32_t indices[3];
+    glm::vec3 normal;
+    float distance;
+};
+
+/**
+ * @brief Face of the polytope with an outward normal, rewound if the origin is on the wrong side
+ */
+EpaFace make_face(const std::vector<SupportPoint> &polytope, uint32_t i0, uint32_t i1, uint32_t i2) {
+    EpaFace face{ { i0, i1, i2 }, glm::vec3(0.0f), 0.0f };
+    const glm::vec3 normal = glm::cross(polytope[i1].w - polytope[i0].w, polytope[i2].w - polytope[i0].w);
+    const float length     = glm::length(normal);
+    if (length < FLT_EPSILON) {
+        face.distance = FLT_MAX; // Degenerate sliver, never the closest face
+        return face;
+    }
+    face.normal   = normal / length;
+    face.distance = glm::dot(face.normal, polytope[i0].w);
+    if (face.distance < 0.0f) {
+        std::swap(face.indices[1], face.indices[2]);
+        face.normal   = -face.normal;
+        face.distance = -face.distance;
+    }
+    return face;
+}
+
+void add_unique_edge(std::vector<std::pair<uint32_t, uint32_t>> &edges, uint32_t from, uint32_t to) {
+    // An edge shared by two removed faces appears once in each direction and is not part of the horizon
+    for (auto it = edges.begin(); it != edges.end(); ++it) {
+        if (it->first == to && it->second == from) {
+            edges.erase(it);
+            return;
+        }
+    }
+    edges.emplace_back(from, to);
+}
+
+bool epa(const ConvexShape &a, const ConvexShape &b, const Simplex &simplex, ConvexContact &contact) {
+    std::vector<SupportPoint> polytope(simplex.points, simplex.points + 4);
+    std::vector<EpaFace> faces = { make_face(polytope, 0, 1, 2), make_face(polytope, 0, 3, 1),
+                                   make_face(polytope, 0, 2, 3), make_face(polytope, 1, 3, 2) };
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    size_t closest = 0;
+    for (int iteration = 0; iteration < max_epa_iterations; ++iteration) {
+        closest = 0;
+        for (size_t i = 1; i < faces.size(); ++i) {
+            if (faces[i].distance < faces[closest].distance)
+                closest = i;
+        }
+        const EpaFace face = faces[closest];
+        if (face.distance == FLT_MAX)
+            return false;
+        const SupportPoint point = minkowski_support(a, b, face.normal);
+        if (glm::dot(face.normal, point.w) - face.distance < epa_tolerance)
+            break;
+        // Remove every face the new point sees and close the hole with a fan around the point
+        edges.clear();
+        for (size_t i = 0; i < faces.size();) {
+            if (!same_direction(faces[i].normal, point.w - polytope[faces[i].indices[0]].w)) {
+                ++i;
+                continue;
+            }
+            for (int e = 0; e < 3; ++e)
+                add_unique_edge(edges, faces[i].indices[e], faces[i].indices[(e + 1) % 3]);
+            faces[i] = faces.back();
+            faces.pop_back();
+        }
+        const auto index = static_cast<uint32_t>(polytope.size());
+        polytope.push_back(point);
+        for (const auto &[from, to] : edges)
+            faces.push_back(make_face(polytope, from, to, index));
+        if (faces.empty())
+            return false;
+    }
+    // Also covers running out of iterations right after an expansion
+    closest = 0;
+    for (size_t i = 1; i < faces.size(); ++i) {
+        if (faces[i].distance < faces[closest].distance)
+            closest = i;
+    }
+    const EpaFace &face = faces[closest];
+    // Barycentric coordinates of the origin's projection give the matching points on both shapes
+    const glm::vec3 projection = face.normal * face.distance;
+    const glm::vec3 w0 = polytope[face.indices[0]].w, w1 = polytope[face.indices[1]].w,
+                    w2 = polytope[face.indices[2]].w;
+    const glm::vec3 v0 = w1 - w0, v1 = w2 - w0, v2 = projection - w0;
+    const float d00 = glm::dot(v0, v0), d01 = glm::dot(v0, v1), d11 = glm::dot(v1, v1);
+    const float d20 = glm::dot(v2, v0), d21 = glm::dot(v2, v1);
+    const float denominator = d00 * d11 - d01 * d01;
+    float u = 1.0f / 3.0f, v = 1.0f / 3.0f, w = 1.0f / 3.0f;
+    if (std::abs(denominator) > FLT_EPSILON) {
+        v = (d11 * d20 - d01 * d21) / denominator;
+        w = (d00 * d21 - d01 * d20) / denominator;
+        u = 1.0f - v - w;
+    }
+    const glm::vec3 point_a = u * polytope[face.indices[0]].a + v * polytope[face.indices[1]].a +
+                              w * polytope[face.indices[2]].a;
+    const glm::vec3 point_b = point_a - projection;
+    contact.normal          = face.normal;
+    contact.depth           = face.distance;
+    contact.point           = (point_a + point_b) * 0.5f;
+    return face.distance > 0.0f;
+}
+} // namespace
+
+glm::vec3 ConvexShape::support(const glm::vec3 &direction) const {
+    if (triangle) {
+        const float d0 = glm::dot(triangle[0], direction);
+        const float d1 = glm::dot(triangle[1], direction);
+        const float d2 = glm::dot(triangle[2], direction);
+        return d0 >= d1 && d0 >= d2 ? triangle[0] : d1 >= d2 ? triangle[1] : triangle[2];
+    }
+    const float length        = glm::length(direction);
+    const glm::vec3 unit      = length > FLT_EPSILON ? direction / length : glm::vec3(1.0f, 0.0f, 0.0f);
+    const glm::mat3 linear    = glm::mat3(cache->matrix);
+    const glm::vec3 local_dir = glm::transpose(linear) * direction;
+    switch (collider->shape) {
+        case Collider::SPHERE:
+            return cache->center + unit * collider->radius;
+        case Collider::BOX: {
+            const glm::vec3 &half = collider->half_extents;
+            const glm::vec3 local(local_dir.x >= 0.0f ? half.x : -half.x, local_dir.y >= 0.0f ? half.y : -half.y,
+                                  local_dir.z >= 0.0f ? half.z : -half.z);
+            return glm::vec3(cache->matrix * glm::vec4(local, 1.0f));
+        }
+        case Collider::CAPSULE: {
+            const bool top = glm::dot(direction, cache->capsule_top - cache->capsule_base) >= 0.0f;
+            return (top ? cache->capsule_top : cache->capsule_base) + unit * collider->capsule_radius;
+        }
+        case Collider::CONVEX_HULL: {
+            hint = collider->convex_hull->support(local_dir, hint);
+            return glm::vec3(cache->matrix * glm::vec4(collider->convex_hull->get_vertices()[hint], 1.0f));
+        }
+        default:
+            return cache->center;
+    }
+}
+
+glm::vec3 ConvexShape::center() const {
+    return triangle ? (triangle[0] + triangle[1] + triangle[2]) / 3.0f : cache->center;
+}
+
+bool gjk_epa(const ConvexShape &a, const ConvexShape &b, ConvexContact &contact) {
+    Simplex simplex;
+    if (!gjk(a, b, simplex))
+        return false;
+    return epa(a, b, simplex, contact);
+}
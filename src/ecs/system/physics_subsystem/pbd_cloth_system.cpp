@@ -1,18 +1,20 @@
+#include <cfloat>
 #include <ecs/component/cloth.h>
+#include <ecs/component/compound_shape.h>
+#include <ecs/component/groups.h>
 #include <ecs/component/transform.h>
 #include <ecs/system/physics_subsystem/pbd_cloth_system.h>
 
 int PBDClothSystem::execution_priority() const { return priority; }
 
 void PBDClothSystem::update(entt::registry &registry, float dt) {
-    auto view           = registry.view<Cloth, Transform>();
-    auto collision_view = registry.view<Collider, Transform>();
+    auto view = registry.view<Cloth, Transform>();
     view.each([&](Cloth &cloth, const Transform &transform) {
         // Phase 1: Predict positions with external forces
         predict_positions(cloth, dt);
         // Phase 2: Handle collisions
-        collision_view.each([&](const Collider &collider, const Transform &collider_transform) {
-            handle_collisions(cloth, collider, collider_transform);
+        each_collider(registry, [&](const Collider &collider, const ColliderCache &collider_cache, const Transform &) {
+            handle_collisions(cloth, collider, collider_cache);
         });
         // Phase 3: Solve constraints iteratively
         solve_constraints(cloth);
@@ -32,12 +34,10 @@ void PBDClothSystem::predict_positions(Cloth &cloth, float dt) {
     }
 }
 
-void PBDClothSystem::handle_collisions(Cloth &cloth, const Collider &collider, const Transform &collider_transform) {
+void PBDClothSystem::handle_collisions(Cloth &cloth, const Collider &collider, const ColliderCache &collider_cache) {
     // Early exit if collider is inactive
     if (!collider.is_active)
         return;
-    // Cache collider type to avoid repeated access
-    const Collider::ShapeType collider_type = collider.shape;
     // Process each cloth vertex
     for (size_t i = 0; i < cloth.positions.size(); ++i) {
         // Skip fixed vertices and infinite mass particles
@@ -46,22 +46,7 @@ void PBDClothSystem::handle_collisions(Cloth &cloth, const Collider &collider, c
         // Get predicted position (current simulation state)
         glm::vec3 &pred_pos = cloth.pred_positions[i];
         glm::vec3 surface_pos, normal;
-        bool collision = false;
-        // Dispatch collision check based on collider type
-        switch (collider_type) {
-            case Collider::SPHERE:
-                collision = collide_sphere(pred_pos, collider, collider_transform, surface_pos, normal);
-                break;
-            case Collider::BOX:
-                collision = collide_box(pred_pos, collider, collider_transform, surface_pos, normal);
-                break;
-            case Collider::CAPSULE:
-                collision = collide_capsule(pred_pos, collider, collider_transform, surface_pos, normal);
-                break;
-            default:
-                get_logger()->error("Collider type not recognized");
-                break;
-        }
+        const bool collision = collide_point(pred_pos, collider, collider_cache, surface_pos, normal);
         if (collision) {
             constexpr float epsilon = 1e-3f;
             // Apply position correction (project out of collider)
@@ -79,6 +64,45 @@ void PBDClothSystem::handle_collisions(Cloth &cloth, const Collider &collider, c
     }
 }
 
+bool PBDClothSystem::collide_point(const glm::vec3 &point, const Collider &collider, const ColliderCache &cache,
+                                   glm::vec3 &surface_pos, glm::vec3 &normal) {
+    bool collision = false;
+    // Dispatch collision check based on collider type
+    switch (collider.shape) {
+        case Collider::SPHERE:
+            collision = collide_sphere(point, collider, cache, surface_pos, normal);
+            break;
+        case Collider::BOX:
+            collision = collide_box(point, collider, cache, surface_pos, normal);
+            break;
+        case Collider::CAPSULE:
+            collision = collide_capsule(point, collider, cache, surface_pos, normal);
+            break;
+        case Collider::CONVEX_HULL:
+            collision = collide_convex_hull(point, collider, cache, surface_pos, normal);
+            break;
+        case Collider::TRIANGLE_MESH:
+            collision = collide_triangle_mesh(point, collider, cache, surface_pos, normal);
+            break;
+        case Collider::SDF:
+            collision = collide_signed_distance_field(point, collider, cache, surface_pos, normal);
+            break;
+        case Collider::PLANE:
+            collision = collide_plane(point, collider, cache, surface_pos, normal);
+            break;
+        case Collider::HEIGHTFIELD:
+            collision = collide_height_field(point, collider, cache, surface_pos, normal);
+            break;
+        case Collider::COMPOUND:
+            collision = collide_compound(point, collider, cache, surface_pos, normal);
+            break;
+        default:
+            get_logger()->error("Collider type not recognized");
+            break;
+    }
+    return collision;
+}
+
 void PBDClothSystem::solve_constraints(Cloth &cloth) {
     for (auto &constraint : cloth.constraints) {
         constraint->project(cloth, solver_iterations);
@@ -99,15 +123,15 @@ void PBDClothSystem::update_positions(Cloth &cloth, float dt) {
  * @brief Checks collision between a point and sphere collider
  * @param point World space point to test
  * @param collider Sphere collider configuration
- * @param transform Collider's transform
+ * @param cache Collider's world-space cache
  * @param[out] surface_pos Closest point on collider surface
  * @param[out] normal Surface normal at collision point
  * @return True if collision occurs
  */
-bool PBDClothSystem::collide_sphere(const glm::vec3 &point, const Collider &collider, const Transform &transform,
+bool PBDClothSystem::collide_sphere(const glm::vec3 &point, const Collider &collider, const ColliderCache &cache,
                                     glm::vec3 &surface_pos, glm::vec3 &normal) {
-    // Calculate world space collider center
-    const glm::vec3 center = transform.position + collider.offset;
+    // World space collider center
+    const glm::vec3 center = cache.center;
     const float radius     = collider.radius;
     const glm::vec3 delta  = point - center;
     const float dist       = glm::length(delta);
@@ -129,17 +153,15 @@ bool PBDClothSystem::collide_sphere(const glm::vec3 &point, const Collider &coll
  * @brief Checks collision between a point and box collider
  * @param point World space point to test
  * @param collider Box collider configuration
- * @param transform Collider's transform
+ * @param cache Collider's world-space cache
  * @param[out] surface_pos Closest point on collider surface
  * @param[out] normal Surface normal at collision point
  * @return True if collision occurs
  */
-bool PBDClothSystem::collide_box(const glm::vec3 &point, const Collider &collider, const Transform &transform,
+bool PBDClothSystem::collide_box(const glm::vec3 &point, const Collider &collider, const ColliderCache &cache,
                                  glm::vec3 &surface_pos, glm::vec3 &normal) {
     // Convert point to collider's local space
-    const glm::mat4 world_to_local =
-        glm::inverse(transform.matrix() * glm::translate(glm::mat4(1.0f), collider.offset));
-    const glm::vec3 local_point = glm::vec3(world_to_local * glm::vec4(point, 1.0f));
+    const glm::vec3 local_point = glm::vec3(cache.inverse_matrix * glm::vec4(point, 1.0f));
 
     const glm::vec3 half = collider.half_extents;
 
@@ -170,29 +192,27 @@ bool PBDClothSystem::collide_box(const glm::vec3 &point, const Collider &collide
             local_normal[closest_axis]  = -1.0f;
         }
         // Convert back to world space
-        const glm::mat4 local_to_world = transform.matrix() * glm::translate(glm::mat4(1.0f), collider.offset);
-        surface_pos                    = glm::vec3(local_to_world * glm::vec4(local_surface, 1.0f));
-        normal                         = glm::normalize(glm::vec3(local_to_world * glm::vec4(local_normal, 0.0f)));
+        surface_pos = glm::vec3(cache.matrix * glm::vec4(local_surface, 1.0f));
+        normal      = glm::normalize(glm::vec3(cache.matrix * glm::vec4(local_normal, 0.0f)));
 
         return true;
     }
     return false;
 }
+
 /**
  * @brief Checks collision between a point and capsule collider
  * @param point World space point to test
  * @param collider Capsule collider configuration
- * @param transform Collider's transform
+ * @param cache Collider's world-space cache
  * @param[out] surface_pos Closest point on collider surface
  * @param[out] normal Surface normal at collision point
  * @return True if collision occurs
  */
-bool PBDClothSystem::collide_capsule(const glm::vec3 &point, const Collider &collider, const Transform &transform,
+bool PBDClothSystem::collide_capsule(const glm::vec3 &point, const Collider &collider, const ColliderCache &cache,
                                      glm::vec3 &surface_pos, glm::vec3 &normal) {
     // Convert point to collider's local space
-    const glm::mat4 world_to_local =
-        glm::inverse(transform.matrix() * glm::translate(glm::mat4(1.0f), collider.offset));
-    const glm::vec3 local_point = glm::vec3(world_to_local * glm::vec4(point, 1.0f));
+    const glm::vec3 local_point = glm::vec3(cache.inverse_matrix * glm::vec4(point, 1.0f));
     // Capsule parameters
     const float radius      = collider.capsule_radius;
     const float half_height = (collider.capsule_height - collider.capsule_radius * 2) * 0.5f;
@@ -222,10 +242,194 @@ bool PBDClothSystem::collide_capsule(const glm::vec3 &point, const Collider &col
             local_normal = glm::vec3(1, 0, 0);
         }
         // Convert results back to world space
-        const glm::mat4 local_to_world = transform.matrix() * glm::translate(glm::mat4(1.0f), collider.offset);
-        surface_pos                    = glm::vec3(local_to_world * glm::vec4(local_surface, 1.0f));
-        normal                         = glm::normalize(glm::vec3(local_to_world * glm::vec4(local_normal, 0.0f)));
+        surface_pos = glm::vec3(cache.matrix * glm::vec4(local_surface, 1.0f));
+        normal      = glm::normalize(glm::vec3(cache.matrix * glm::vec4(local_normal, 0.0f)));
         return true;
     }
     return false;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Checks collision between a point and convex hull collider
+ * @param point World space point to test
+ * @param collider Convex hull collider configuration
+ * @param cache Collider's world-space cache
+ * @param[out] surface_pos Closest point on collider surface
+ * @param[out] normal Surface normal at collision point
+ * @return True if collision occurs
+ */
+bool PBDClothSystem::collide_convex_hull(const glm::vec3 &point, const Collider &collider, const ColliderCache &cache,
+                                         glm::vec3 &surface_pos, glm::vec3 &normal) {
+    if (!collider.convex_hull)
+        return false;
+    // Convert point to collider's local space
+    const glm::vec3 local_point = glm::vec3(cache.inverse_matrix * glm::vec4(point, 1.0f));
+    // Inside if behind every face plane, leave through the nearest one
+    const ConvexHull::Face *nearest = nullptr;
+    float max_distance              = -FLT_MAX;
+    for (const auto &face : collider.convex_hull->get_faces()) {
+        const float distance = glm::dot(face.normal, local_point) - face.offset;
+        if (distance >= 0.0f)
+            return false;
+        if (distance > max_distance) {
+            max_distance = distance;
+            nearest      = &face;
+        }
+    }
+    if (!nearest)
+        return false;
+    const glm::vec3 local_surface = local_point - nearest->normal * max_distance;
+    // Convert results back to world space, normals go through the inverse transpose
+    surface_pos = glm::vec3(cache.matrix * glm::vec4(local_surface, 1.0f));
+    normal      = glm::normalize(glm::transpose(glm::mat3(cache.inverse_matrix)) * nearest->normal);
+    return true;
+}
+
+/**
+ * @brief Checks collision between a point and triangle mesh collider
+ * @param point World space point to test
+ * @param collider Triangle mesh collider configuration
+ * @param cache Collider's world-space cache
+ * @param[out] surface_pos Closest point on collider surface
+ * @param[out] normal Surface normal at collision point
+ * @return True if collision occurs
+ */
+bool PBDClothSystem::collide_triangle_mesh(const glm::vec3 &point, const Collider &collider, const ColliderCache &cache,
+                                           glm::vec3 &surface_pos, glm::vec3 &normal) {
+    if (!collider.triangle_mesh)
+        return false;
+    const auto &mesh = *collider.triangle_mesh;
+    // Only triangles within the thickness matter, found through the BVH in mesh space
+    const AABB bounds = AABB{ point - glm::vec3(mesh_thickness), point + glm::vec3(mesh_thickness) }.transformed(
+        cache.inverse_matrix);
+    float min_distance = mesh_thickness;
+    bool collision     = false;
+    mesh.query(bounds.min, bounds.max, [&](uint32_t triangle) {
+        const auto local        = mesh.get_triangle(triangle);
+        const glm::vec3 a       = glm::vec3(cache.matrix * glm::vec4(local[0], 1.0f));
+        const glm::vec3 b       = glm::vec3(cache.matrix * glm::vec4(local[1], 1.0f));
+        const glm::vec3 c       = glm::vec3(cache.matrix * glm::vec4(local[2], 1.0f));
+        const glm::vec3 face    = glm::cross(b - a, c - a);
+        const glm::vec3 closest = TriangleMeshBVH::closest_point_on_triangle(point, a, b, c);
+        const float distance    = glm::length(point - closest);
+        if (distance >= min_distance || glm::dot(face, face) < 1e-12f)
+            return;
+        // Always resolve to the front side, a particle slightly behind a face was pushed through it
+        min_distance = distance;
+        normal       = glm::normalize(face);
+        surface_pos  = closest + normal * mesh_thickness;
+        collision    = true;
+    });
+    return collision;
+}
+
+/**
+ * @brief Checks collision between a point and signed distance field collider
+ * @param point World space point to test
+ * @param collider Signed distance field collider configuration
+ * @param cache Collider's world-space cache
+ * @param[out] surface_pos Closest point on collider surface
+ * @param[out] normal Surface normal at collision point
+ * @return True if collision occurs
+ */
+bool PBDClothSystem::collide_signed_distance_field(const glm::vec3 &point, const Collider &collider,
+                                                   const ColliderCache &cache, glm::vec3 &surface_pos,
+                                                   glm::vec3 &normal) {
+    if (!collider.signed_distance_field)
+        return false;
+    // One field lookup instead of a BVH traversal, the same thickness as for triangle meshes
+    const glm::vec3 local_point = glm::vec3(cache.inverse_matrix * glm::vec4(point, 1.0f));
+    glm::vec3 gradient;
+    const float distance = collider.signed_distance_field->sample(local_point, gradient);
+    if (distance >= mesh_thickness || glm::dot(gradient, gradient) < 1e-12f)
+        return false;
+    const glm::vec3 local_normal  = glm::normalize(gradient);
+    const glm::vec3 local_surface = local_point - local_normal * distance;
+    // Convert results back to world space, normals go through the inverse transpose
+    normal      = glm::normalize(glm::transpose(glm::mat3(cache.inverse_matrix)) * local_normal);
+    surface_pos = glm::vec3(cache.matrix * glm::vec4(local_surface, 1.0f)) + normal * mesh_thickness;
+    return true;
+}
+
+/**
+ * @brief Checks collision between a point and plane collider
+ * @param point World space point to test
+ * @param collider Plane collider configuration
+ * @param cache Collider's world-space cache
+ * @param[out] surface_pos Closest point on collider surface
+ * @param[out] normal Surface normal at collision point
+ * @return True if collision occurs
+ */
+bool PBDClothSystem::collide_plane(const glm::vec3 &point, const Collider &collider, const ColliderCache &cache,
+                                   glm::vec3 &surface_pos, glm::vec3 &normal) {
+    normal               = cache.basis[1];
+    const float distance = glm::dot(point - cache.center, normal);
+    if (distance >= mesh_thickness)
+        return false;
+    surface_pos = point + normal * (mesh_thickness - distance);
+    return true;
+}
+
+/**
+ * @brief Checks collision between a point and heightfield collider
+ * @param point World space point to test
+ * @param collider Heightfield collider configuration
+ * @param cache Collider's world-space cache
+ * @param[out] surface_pos Closest point on collider surface
+ * @param[out] normal Surface normal at collision point
+ * @return True if collision occurs
+ */
+bool PBDClothSystem::collide_height_field(const glm::vec3 &point, const Collider &collider, const ColliderCache &cache,
+                                          glm::vec3 &surface_pos, glm::vec3 &normal) {
+    if (!collider.height_field)
+        return false;
+    // A single cell lookup, the distance is measured to the plane of the triangle below the particle
+    const glm::vec3 local_point = glm::vec3(cache.inverse_matrix * glm::vec4(point, 1.0f));
+    float height;
+    glm::vec3 local_normal;
+    if (!collider.height_field->height_at(local_point.x, local_point.z, height, local_normal))
+        return false;
+    const float distance = (local_point.y - height) * local_normal.y;
+    if (distance >= mesh_thickness)
+        return false;
+    const glm::vec3 local_surface = local_point - local_normal * distance;
+    normal      = glm::normalize(glm::transpose(glm::mat3(cache.inverse_matrix)) * local_normal);
+    surface_pos = glm::vec3(cache.matrix * glm::vec4(local_surface, 1.0f)) + normal * mesh_thickness;
+    return true;
+}
+
+/**
+ * @brief Checks collision between a point and the children of a compound collider
+ * @param point World space point to test
+ * @param collider Compound collider configuration
+ * @param cache Collider's world-space cache
+ * @param[out] surface_pos Closest point on the surface of the deepest child hit
+ * @param[out] normal Surface normal at collision point
+ * @return True if collision occurs
+ */
+bool PBDClothSystem::collide_compound(const glm::vec3 &point, const Collider &collider, const ColliderCache &cache,
+                                      glm::vec3 &surface_pos, glm::vec3 &normal) {
+    if (!collider.compound)
+        return false;
+    const auto &shape            = *collider.compound;
+    const glm::vec3 local_point  = glm::vec3(cache.inverse_matrix * glm::vec4(point, 1.0f));
+    const glm::vec3 local_margin = glm::vec3(mesh_thickness);
+    bool collision               = false;
+    float deepest                = -1.0f;
+    ColliderCache child_cache;
+    // Only children whose bounds hold the point are tested, keeping the one that pushes it out furthest
+    shape.query({ local_point - local_margin, local_point + local_margin }, [&](uint32_t child) {
+        shape.child_cache(cache, child, child_cache);
+        glm::vec3 child_surface, child_normal;
+        if (!collide_point(point, shape.get_children()[child].collider, child_cache, child_surface, child_normal))
+            return;
+        const float depth = glm::length(child_surface - point);
+        if (depth <= deepest)
+            return;
+        deepest     = depth;
+        collision   = true;
+        surface_pos = child_surface;
+        normal      = child_normal;
+    });
+    return collision;
+}
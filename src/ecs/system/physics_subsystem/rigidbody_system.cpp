@@ -1,5 +1,6 @@
-#include <ecs/component/rigidbody.h>
-#include <ecs/component/transform.h>
+#include <cmath>
+#include <core/parallel/thread_pool.h>
+#include <ecs/component/groups.h>
 #include <ecs/system/physics_subsystem/rigidbody_system.h>
 #include <glm/gtc/quaternion.hpp>
 
@@ -8,16 +9,131 @@ int RigidBodySystem::execution_priority() const { return priority; }
 void RigidBodySystem::update(entt::registry &registry, float dt) { integrate_forces(registry, dt); }
 
 void RigidBodySystem::integrate_forces(entt::registry &registry, float dt) {
-    auto view = registry.view<Transform, RigidBody>();
-    view.each([dt, this](auto &t, auto &rb) {
-        if (rb.is_kinematic || rb.mass <= 0.0f)
-            return;
-        rb.integrate(dt, gravity);
-        t.position += rb.linear_velocity * dt;
-        // Quaternion integration with proper angular velocity handling
-        glm::quat rotation = t.orientation();
-        const glm::quat angular_quat(0, rb.angular_velocity.x, rb.angular_velocity.y, rb.angular_velocity.z);
-        rotation   = glm::normalize(rotation + 0.5f * dt * angular_quat * rotation);
-        t.rotation = glm::eulerAngles(rotation);
+    bodies.clear();
+    // Group order, so the lookups of gather and scatter walk both pools front to back
+    each_body(registry, [&](auto entity, const Transform &t, RigidBody &rb) {
+        rb.previous_position = t.position;
+        // Children follow their parent instead
+        if (!rb.is_kinematic && !rb.is_sleeping && rb.mass > 0.0f && t.parent == entt::null)
+            bodies.push_back(entity);
     });
+    batches.resize((bodies.size() + lane_width - 1) / lane_width);
+    // Each batch is gathered, integrated and scattered back to back while its lanes are still in cache
+    get_thread_pool()->parallel_for(batches.size(), integrate_grain, [&](size_t, size_t begin, size_t end) {
+        for (size_t batch = begin; batch < end; ++batch) {
+            gather(registry, batch);
+            integrate_lanes(batches[batch], dt, gravity);
+            scatter(registry, batch);
+        }
+    });
+}
+
+void RigidBodySystem::gather(entt::registry &registry, size_t batch) {
+    BodyLanes &lanes   = batches[batch];
+    const size_t first = batch * lane_width;
+    for (size_t lane = 0; lane < lane_width; ++lane) {
+        if (first + lane >= bodies.size()) {
+            lanes.inverse_mass[lane]  = 0.0f;
+            lanes.gravity_scale[lane] = 0.0f;
+            lanes.rotates[lane]       = false;
+            for (int axis = 0; axis < 3; ++axis) {
+                lanes.linear_velocity[axis][lane] = lanes.angular_velocity[axis][lane] = 0.0f;
+                lanes.force[axis][lane] = lanes.torque[axis][lane] = 0.0f;
+            }
+            for (int component = 0; component < 4; ++component)
+                lanes.orientation[component][lane] = component == 3 ? 1.0f : 0.0f;
+            continue;
+        }
+        const auto &t  = registry.get<Transform>(bodies[first + lane]);
+        const auto &rb = registry.get<RigidBody>(bodies[first + lane]);
+        for (int axis = 0; axis < 3; ++axis) {
+            lanes.position[axis][lane]         = t.position[axis];
+            lanes.linear_velocity[axis][lane]  = rb.linear_velocity[axis];
+            lanes.angular_velocity[axis][lane] = rb.angular_velocity[axis];
+            lanes.force[axis][lane]            = rb.force_accumulator[axis];
+            lanes.torque[axis][lane]           = rb.torque_accumulator[axis];
+            lanes.linear_free[axis][lane]      = rb.freeze_position[axis] ? 0.0f : 1.0f;
+            lanes.angular_free[axis][lane]     = rb.freeze_rotation[axis] ? 0.0f : 1.0f;
+            for (int row = 0; row < 3; ++row)
+                lanes.inverse_inertia[axis * 3 + row][lane] = rb.inv_inertia_tensor[axis][row];
+        }
+        lanes.inverse_mass[lane]    = 1.0f / rb.mass;
+        lanes.linear_damping[lane]  = rb.linear_damping;
+        lanes.angular_damping[lane] = rb.angular_damping;
+        lanes.gravity_scale[lane]   = rb.use_gravity ? 1.0f : 0.0f;
+        lanes.orientation[0][lane]  = t.rotation.x;
+        lanes.orientation[1][lane]  = t.rotation.y;
+        lanes.orientation[2][lane]  = t.rotation.z;
+        lanes.orientation[3][lane]  = t.rotation.w;
+        // Bodies that cannot turn this step keep their orientation bit for bit, so their cached matrices stay valid
+        lanes.rotates[lane] = rb.angular_velocity != glm::vec3(0.0f) || rb.torque_accumulator != glm::vec3(0.0f);
+    }
+}
+
+void RigidBodySystem::integrate_lanes(BodyLanes &lanes, float dt, const glm::vec3 &gravity) {
+    auto &p = lanes.position;
+    auto &q = lanes.orientation;
+    auto &v = lanes.linear_velocity;
+    auto &w = lanes.angular_velocity;
+    const auto &f   = lanes.force;
+    const auto &tau = lanes.torque;
+    const auto &ii  = lanes.inverse_inertia;
+    // Copied out first, the compiler cannot tell that gravity does not overlap the lanes
+    const float gx = gravity.x, gy = gravity.y, gz = gravity.z;
+    // Every axis is spelled out and the clamps are plain ?: on values, so the loop body has no control flow
+    for (size_t i = 0; i < lane_width; ++i) {
+        // Linear motion
+        const float linear_damping = 1.0f - lanes.linear_damping[i] * dt;
+        const float linear_decay   = linear_damping > 0.0f ? linear_damping : 0.0f;
+        const float lx             = f[0][i] * lanes.inverse_mass[i] + gx * lanes.gravity_scale[i];
+        const float ly             = f[1][i] * lanes.inverse_mass[i] + gy * lanes.gravity_scale[i];
+        const float lz             = f[2][i] * lanes.inverse_mass[i] + gz * lanes.gravity_scale[i];
+        v[0][i]                    = (v[0][i] + lx * dt) * linear_decay * lanes.linear_free[0][i];
+        v[1][i]                    = (v[1][i] + ly * dt) * linear_decay * lanes.linear_free[1][i];
+        v[2][i]                    = (v[2][i] + lz * dt) * linear_decay * lanes.linear_free[2][i];
+        p[0][i] += v[0][i] * dt;
+        p[1][i] += v[1][i] * dt;
+        p[2][i] += v[2][i] * dt;
+        // Angular motion
+        const float angular_damping = 1.0f - lanes.angular_damping[i] * dt;
+        const float angular_decay   = angular_damping > 0.0f ? angular_damping : 0.0f;
+        const float ax              = ii[0][i] * tau[0][i] + ii[3][i] * tau[1][i] + ii[6][i] * tau[2][i];
+        const float ay              = ii[1][i] * tau[0][i] + ii[4][i] * tau[1][i] + ii[7][i] * tau[2][i];
+        const float az              = ii[2][i] * tau[0][i] + ii[5][i] * tau[1][i] + ii[8][i] * tau[2][i];
+        w[0][i]                     = (w[0][i] + ax * dt) * angular_decay * lanes.angular_free[0][i];
+        w[1][i]                     = (w[1][i] + ay * dt) * angular_decay * lanes.angular_free[1][i];
+        w[2][i]                     = (w[2][i] + az * dt) * angular_decay * lanes.angular_free[2][i];
+        // q += 0.5 * dt * (0, w) * q, then renormalize
+        const float h              = 0.5f * dt;
+        const float qx             = q[0][i], qy = q[1][i], qz = q[2][i], qw = q[3][i];
+        const float wx             = w[0][i], wy = w[1][i], wz = w[2][i];
+        const float nx             = qx + h * (wx * qw + wy * qz - wz * qy);
+        const float ny             = qy + h * (wy * qw + wz * qx - wx * qz);
+        const float nz             = qz + h * (wz * qw + wx * qy - wy * qx);
+        const float nw             = qw - h * (wx * qx + wy * qy + wz * qz);
+        const float inverse_length = 1.0f / std::sqrt(nx * nx + ny * ny + nz * nz + nw * nw);
+        q[0][i]                    = nx * inverse_length;
+        q[1][i]                    = ny * inverse_length;
+        q[2][i]                    = nz * inverse_length;
+        q[3][i]                    = nw * inverse_length;
+    }
+}
+
+void RigidBodySystem::scatter(entt::registry &registry, size_t batch) {
+    const BodyLanes &lanes = batches[batch];
+    const size_t first     = batch * lane_width;
+    for (size_t lane = 0; lane < lane_width && first + lane < bodies.size(); ++lane) {
+        auto &t  = registry.get<Transform>(bodies[first + lane]);
+        auto &rb = registry.get<RigidBody>(bodies[first + lane]);
+        for (int axis = 0; axis < 3; ++axis) {
+            t.position[axis]          = lanes.position[axis][lane];
+            rb.linear_velocity[axis]  = lanes.linear_velocity[axis][lane];
+            rb.angular_velocity[axis] = lanes.angular_velocity[axis][lane];
+        }
+        rb.force_accumulator  = glm::vec3(0);
+        rb.torque_accumulator = glm::vec3(0);
+        if (lanes.rotates[lane])
+            t.rotation = glm::quat(lanes.orientation[3][lane], lanes.orientation[0][lane], lanes.orientation[1][lane],
+                                   lanes.orientation[2][lane]);
+    }
 }
@@ -0,0 +1,682 @@
+#include <algorithm>
+#include <cmath>
+#include <core/parallel/thread_pool.h>
+#include <ecs/component/collider_cache.h>
+#include <ecs/component/compound_shape.h>
+#include <ecs/system/physics_subsystem/collision_system.h>
+#include <ecs/system/physics_subsystem/scene_query.h>
+#include <glm/ext/matrix_transform.hpp>
+
+namespace {
+constexpr float epsilon                = 1e-6f;
+constexpr int max_sphere_trace_steps   = 64;
+constexpr float sphere_trace_tolerance = 1e-3f;
+
+/**
+ * @brief Reciprocal of a direction with zero components nudged away from zero, so slab tests never see 0 * inf
+ */
+glm::vec3 safe_inverse(const glm::vec3 &direction) {
+    glm::vec3 inverse;
+    for (int i = 0; i < 3; ++i)
+        inverse[i] = 1.0f / (std::abs(direction[i]) > 1e-12f ? direction[i] : std::copysign(1e-12f, direction[i]));
+    return inverse;
+}
+
+/**
+ * @brief Parameter interval of a ray inside a box, empty if t_near > t_far
+ */
+void slab(const glm::vec3 &origin, const glm::vec3 &inverse, const glm::vec3 &min, const glm::vec3 &max,
+          float &t_near, float &t_far) {
+    const glm::vec3 t0 = (min - origin) * inverse;
+    const glm::vec3 t1 = (max - origin) * inverse;
+    const glm::vec3 lo = glm::min(t0, t1), hi = glm::max(t0, t1);
+    t_near             = std::max(std::max(lo.x, lo.y), lo.z);
+    t_far              = std::min(std::min(hi.x, hi.y), hi.z);
+}
+
+/**
+ * @brief Ray against a sphere, direction of unit length, an origin inside hits at 0
+ */
+bool ray_sphere(const glm::vec3 &origin, const glm::vec3 &direction, const glm::vec3 &center, float radius,
+                float &t) {
+    const glm::vec3 m = origin - center;
+    const float b     = glm::dot(m, direction);
+    const float c     = glm::dot(m, m) - radius * radius;
+    if (c <= 0.0f) {
+        t = 0.0f;
+        return true;
+    }
+    const float discriminant = b * b - c;
+    if (b > 0.0f || discriminant < 0.0f)
+        return false;
+    t = -b - std::sqrt(discriminant);
+    return true;
+}
+
+/**
+ * @brief Ray against a capsule, the first entry into the cylinder or either cap sphere
+ */
+bool ray_capsule(const glm::vec3 &origin, const glm::vec3 &direction, const glm::vec3 &a, const glm::vec3 &b,
+                 float radius, float &t) {
+    const glm::vec3 ba = b - a, oa = origin - a;
+    const float baba   = glm::dot(ba, ba);
+    const float bard   = glm::dot(ba, direction);
+    const float baoa   = glm::dot(ba, oa);
+    bool hit           = false;
+    t                  = FLT_MAX;
+    // Infinite cylinder around the segment, accepted only between the end points
+    const float k2 = baba - bard * bard;
+    if (k2 > epsilon) {
+        const float k1           = baba * glm::dot(oa, direction) - baoa * bard;
+        const float k0           = baba * glm::dot(oa, oa) - baoa * baoa - radius * radius * baba;
+        const float discriminant = k1 * k1 - k2 * k0;
+        if (discriminant >= 0.0f) {
+            const float t_cylinder = (-k1 - std::sqrt(discriminant)) / k2;
+            const float y          = baoa + t_cylinder * bard;
+            if (t_cylinder >= 0.0f && y > 0.0f && y < baba) {
+                t   = t_cylinder;
+                hit = true;
+            }
+        }
+    }
+    float t_cap;
+    for (const glm::vec3 &cap : { a, b }) {
+        if (ray_sphere(origin, direction, cap, radius, t_cap) && t_cap < t) {
+            t   = t_cap;
+            hit = true;
+        }
+    }
+    // Inside the cylinder part: neither test above reports it
+    if (!hit && k2 > epsilon && baba > epsilon) {
+        const float s       = std::clamp(baoa / baba, 0.0f, 1.0f);
+        const glm::vec3 off = oa - ba * s;
+        if (glm::dot(off, off) <= radius * radius) {
+            t   = 0.0f;
+            hit = true;
+        }
+    }
+    return hit;
+}
+
+/**
+ * @brief Exact ray test against one collider
+ * @param direction Unit direction in world space, t is measured in world units
+ * @param normal [out] World-space surface normal facing the ray, -direction if the origin is inside
+ */
+bool ray_collider(const Collider &c, const ColliderCache &w, const glm::vec3 &origin, const glm::vec3 &direction,
+                  float max_distance, float &t, glm::vec3 &normal) {
+    // Local-space rays keep the world parameterization, so hits compare across shapes
+    const glm::vec3 local_origin    = glm::vec3(w.inverse_matrix * glm::vec4(origin, 1.0f));
+    const glm::vec3 local_direction = glm::mat3(w.inverse_matrix) * direction;
+    const glm::mat3 normal_to_world = glm::transpose(glm::mat3(w.inverse_matrix));
+    glm::vec3 local_normal(0.0f);
+    bool hit = false;
+    switch (c.shape) {
+        case Collider::SPHERE:
+            if (!ray_sphere(origin, direction, w.center, c.radius, t) || t > max_distance)
+                return false;
+            normal = t > 0.0f ? glm::normalize(origin + direction * t - w.center) : -direction;
+            return true;
+        case Collider::CAPSULE: {
+            if (!ray_capsule(origin, direction, w.capsule_base, w.capsule_top, c.capsule_radius, t) ||
+                t > max_distance)
+                return false;
+            const glm::vec3 point = origin + direction * t;
+            const glm::vec3 axis  = w.capsule_top - w.capsule_base;
+            const float s         = glm::dot(point - w.capsule_base, axis) / std::max(glm::dot(axis, axis), epsilon);
+            const glm::vec3 core  = w.capsule_base + axis * std::clamp(s, 0.0f, 1.0f);
+            normal                = t > 0.0f ? glm::normalize(point - core) : -direction;
+            return true;
+        }
+        case Collider::BOX: {
+            float t_near = 0.0f, t_far = max_distance;
+            int axis = -1;
+            for (int i = 0; i < 3; ++i) {
+                const float half = c.half_extents[i];
+                if (std::abs(local_direction[i]) < epsilon) {
+                    if (std::abs(local_origin[i]) > half)
+                        return false;
+                    continue;
+                }
+                float t0 = (-half - local_origin[i]) / local_direction[i];
+                float t1 = (half - local_origin[i]) / local_direction[i];
+                if (t0 > t1)
+                    std::swap(t0, t1);
+                if (t0 > t_near) {
+                    t_near = t0;
+                    axis   = i;
+                }
+                t_far = std::min(t_far, t1);
+                if (t_near > t_far)
+                    return false;
+            }
+            t = t_near;
+            if (axis >= 0)
+                local_normal[axis] = local_direction[axis] > 0.0f ? -1.0f : 1.0f;
+            hit = true;
+            break;
+        }
+        case Collider::CONVEX_HULL: {
+            if (!c.convex_hull)
+                return false;
+            // Clip the ray against every face plane
+            float t_near = 0.0f, t_far = max_distance;
+            for (const auto &face : c.convex_hull->get_faces()) {
+                const float denominator = glm::dot(face.normal, local_direction);
+                const float distance    = glm::dot(face.normal, local_origin) - face.offset;
+                if (std::abs(denominator) < epsilon) {
+                    if (distance > 0.0f)
+                        return false;
+                    continue;
+                }
+                const float t_plane = -distance / denominator;
+                if (denominator < 0.0f && t_plane > t_near) {
+                    t_near       = t_plane;
+                    local_normal = face.normal;
+                } else if (denominator > 0.0f) {
+                    t_far = std::min(t_far, t_plane);
+                }
+                if (t_near > t_far)
+                    return false;
+            }
+            t   = t_near;
+            hit = true;
+            break;
+        }
+        case Collider::TRIANGLE_MESH: {
+            if (!c.triangle_mesh)
+                return false;
+            const auto &mesh = *c.triangle_mesh;
+            float closest    = max_distance;
+            mesh.raycast(local_origin, local_direction, max_distance, [&](uint32_t triangle, float &max_t) {
+                const auto [v0, v1, v2] = mesh.get_triangle(triangle);
+                float distance;
+                if (TriangleMeshBVH::intersect_triangle(local_origin, local_direction, v0, v1, v2, distance) &&
+                    distance < max_t) {
+                    max_t        = distance;
+                    closest      = distance;
+                    local_normal = glm::cross(v1 - v0, v2 - v0);
+                    hit          = true;
+                }
+            });
+            t = closest;
+            break;
+        }
+        case Collider::PLANE:
+            // Solid below the local x/z plane, an origin inside hits at 0
+            if (local_origin.y <= 0.0f) {
+                t = 0.0f;
+            } else {
+                if (local_direction.y >= 0.0f)
+                    return false;
+                t            = -local_origin.y / local_direction.y;
+                local_normal = glm::vec3(0.0f, 1.0f, 0.0f);
+            }
+            hit = true;
+            break;
+        case Collider::HEIGHTFIELD: {
+            if (!c.height_field)
+                return false;
+            uint32_t triangle;
+            if (!c.height_field->raycast(local_origin, local_direction, max_distance, t, triangle))
+                return false;
+            const auto [v0, v1, v2] = c.height_field->get_triangle(triangle);
+            local_normal            = glm::cross(v1 - v0, v2 - v0);
+            hit                     = true;
+            break;
+        }
+        case Collider::COMPOUND: {
+            if (!c.compound)
+                return false;
+            // Nearest hit among the children overlapping the part of the ray inside the compound bounds
+            const auto &shape = *c.compound;
+            const AABB bounds = shape.get_bounds();
+            float t_near, t_far;
+            slab(local_origin, safe_inverse(local_direction), bounds.min, bounds.max, t_near, t_far);
+            t_near = std::max(t_near, 0.0f);
+            t_far  = std::min(t_far, max_distance);
+            if (t_near > t_far)
+                return false;
+            const glm::vec3 entry = local_origin + local_direction * t_near;
+            const glm::vec3 exit  = local_origin + local_direction * t_far;
+            float closest         = t_far;
+            ColliderCache child_w;
+            shape.query({ glm::min(entry, exit), glm::max(entry, exit) }, [&](uint32_t child) {
+                shape.child_cache(w, child, child_w);
+                float child_t;
+                glm::vec3 child_normal;
+                if (ray_collider(shape.get_children()[child].collider, child_w, origin, direction, closest, child_t,
+                                 child_normal) &&
+                    (!hit || child_t < closest)) {
+                    closest = child_t;
+                    normal  = child_normal;
+                    hit     = true;
+                }
+            });
+            t = closest;
+            // Children already report world-space normals
+            return hit;
+        }
+        case Collider::SDF: {
+            if (!c.signed_distance_field)
+                return false;
+            // Sphere tracing from where the ray enters the baked domain
+            const auto &field = *c.signed_distance_field;
+            const float scale = glm::length(local_direction);
+            float t_near, t_far;
+            slab(local_origin, safe_inverse(local_direction), field.get_bounds_min(), field.get_bounds_max(), t_near,
+                 t_far);
+            t = std::max(t_near, 0.0f);
+            glm::vec3 gradient;
+            for (int i = 0; i < max_sphere_trace_steps && t <= std::min(t_far, max_distance); ++i) {
+                const float distance = field.sample(local_origin + local_direction * t, gradient);
+                if (distance < sphere_trace_tolerance) {
+                    local_normal = gradient;
+                    hit          = true;
+                    break;
+                }
+                t += distance / scale;
+            }
+            break;
+        }
+    }
+    if (!hit || t > max_distance)
+        return false;
+    if (glm::dot(local_normal, local_normal) < epsilon * epsilon) {
+        normal = -direction;
+        return true;
+    }
+    normal = glm::normalize(normal_to_world * local_normal);
+    // Triangles are two-sided
+    if (glm::dot(normal, direction) > 0.0f)
+        normal = -normal;
+    return true;
+}
+
+/**
+ * @brief Query shape of a sweep moved to a point along its path
+ */
+void place_swept_shape(const SceneQuery::Sweep &sweep, const glm::vec3 &direction, float t, ColliderCache &cache) {
+    const glm::vec3 motion = direction * t;
+    cache.capsule_base     = sweep.base + motion;
+    cache.capsule_top      = sweep.top + motion;
+    cache.center           = (cache.capsule_base + cache.capsule_top) * 0.5f;
+    cache.matrix           = glm::translate(glm::mat4(1.0f), cache.center);
+    cache.inverse_matrix   = glm::translate(glm::mat4(1.0f), -cache.center);
+    cache.aabb.min         = glm::min(cache.capsule_base, cache.capsule_top) - glm::vec3(sweep.radius);
+    cache.aabb.max         = glm::max(cache.capsule_base, cache.capsule_top) + glm::vec3(sweep.radius);
+}
+} // namespace
+
+void SceneQuery::rebuild(const entt::registry &registry) {
+    m_next_sources.clear();
+    registry.view<Collider, ColliderCache>().each(
+        [&](auto entity, const Collider &collider, const ColliderCache &cache) {
+            if (collider.is_active)
+                m_next_sources.push_back({ entity, cache.transform_version, cache.collider_version, collider.layer,
+                                           collider.shape == Collider::PLANE });
+        });
+    if (m_next_sources == m_sources)
+        return;
+    // The same proxies in the same order keep the hierarchy valid, only its boxes need to grow or shrink
+    const bool same_proxies = m_next_sources.size() == m_sources.size() &&
+                              std::equal(m_next_sources.begin(), m_next_sources.end(), m_sources.begin(),
+                                         [](const Source &a, const Source &b) {
+                                             return a.entity == b.entity && a.unbounded == b.unbounded;
+                                         });
+    m_sources.swap(m_next_sources);
+    if (same_proxies && m_refits < max_refits) {
+        ++m_refits;
+        refit(registry);
+        return;
+    }
+    m_refits = 0;
+    m_entities.clear();
+    m_bounds.clear();
+    m_layers.clear();
+    m_nodes.clear();
+    m_order.clear();
+    m_unbounded.clear();
+    registry.view<Collider, ColliderCache>().each(
+        [&](auto entity, const Collider &collider, const ColliderCache &cache) {
+            if (!collider.is_active)
+                return;
+            const auto proxy = static_cast<uint32_t>(m_entities.size());
+            (collider.shape == Collider::PLANE ? m_unbounded : m_order).push_back(proxy);
+            m_entities.push_back(entity);
+            m_bounds.push_back(cache.aabb);
+            m_layers.push_back(collider.layer);
+        });
+    if (!m_order.empty())
+        build(0, static_cast<uint32_t>(m_order.size()));
+}
+
+void SceneQuery::refit(const entt::registry &registry) {
+    for (size_t proxy = 0; proxy < m_sources.size(); ++proxy) {
+        m_bounds[proxy] = registry.get<ColliderCache>(m_sources[proxy].entity).aabb;
+        m_layers[proxy] = m_sources[proxy].layer;
+    }
+    // Children are always stored after their parent, walking backwards refits them first
+    for (size_t index = m_nodes.size(); index-- > 0;) {
+        Node &node = m_nodes[index];
+        for (uint32_t lane = 0; lane < node.count; ++lane) {
+            AABB bounds;
+            if (node.child[lane] < 0) {
+                bounds = m_bounds[~node.child[lane]];
+            } else {
+                const Node &child = m_nodes[node.child[lane]];
+                for (uint32_t i = 0; i < child.count; ++i) {
+                    bounds.min = glm::min(bounds.min, glm::vec3(child.min_x[i], child.min_y[i], child.min_z[i]));
+                    bounds.max = glm::max(bounds.max, glm::vec3(child.max_x[i], child.max_y[i], child.max_z[i]));
+                }
+            }
+            node.min_x[lane] = bounds.min.x;
+            node.min_y[lane] = bounds.min.y;
+            node.min_z[lane] = bounds.min.z;
+            node.max_x[lane] = bounds.max.x;
+            node.max_y[lane] = bounds.max.y;
+            node.max_z[lane] = bounds.max.z;
+        }
+    }
+}
+
+int32_t SceneQuery::build(uint32_t begin, uint32_t end) {
+    const auto index = static_cast<int32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+    // Split the range into node_width groups by repeated median splits along the widest centroid axis
+    std::pair<uint32_t, uint32_t> groups[node_width] = { { begin, end } };
+    size_t group_count                                = 1;
+    while (group_count < node_width) {
+        auto largest = std::max_element(groups, groups + group_count, [](const auto &a, const auto &b) {
+            return a.second - a.first < b.second - b.first;
+        });
+        if (largest->second - largest->first < 2)
+            break;
+        const auto [first, last] = *largest;
+        AABB centroids;
+        for (uint32_t i = first; i < last; ++i) {
+            centroids.min = glm::min(centroids.min, m_bounds[m_order[i]].center());
+            centroids.max = glm::max(centroids.max, m_bounds[m_order[i]].center());
+        }
+        const glm::vec3 extent = centroids.max - centroids.min;
+        const int axis         = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+        const uint32_t middle  = first + (last - first) / 2;
+        std::nth_element(m_order.begin() + first, m_order.begin() + middle, m_order.begin() + last,
+                         [&](uint32_t a, uint32_t b) {
+                             return m_bounds[a].center()[axis] < m_bounds[b].center()[axis];
+                         });
+        *largest              = { first, middle };
+        groups[group_count++] = { middle, last };
+    }
+    // Children are built first, m_nodes may reallocate
+    int32_t children[node_width];
+    AABB bounds[node_width];
+    for (size_t lane = 0; lane < group_count; ++lane) {
+        const auto [first, last] = groups[lane];
+        if (last - first == 1) {
+            children[lane] = ~static_cast<int32_t>(m_order[first]);
+            bounds[lane]   = m_bounds[m_order[first]];
+            continue;
+        }
+        children[lane] = build(first, last);
+        for (uint32_t i = first; i < last; ++i)
+            bounds[lane] = AABB::merge(bounds[lane], m_bounds[m_order[i]]);
+    }
+    Node &node = m_nodes[index];
+    node.count = static_cast<uint32_t>(group_count);
+    for (size_t lane = 0; lane < node_width; ++lane) {
+        const bool used  = lane < group_count;
+        node.min_x[lane] = used ? bounds[lane].min.x : FLT_MAX;
+        node.min_y[lane] = used ? bounds[lane].min.y : FLT_MAX;
+        node.min_z[lane] = used ? bounds[lane].min.z : FLT_MAX;
+        node.max_x[lane] = used ? bounds[lane].max.x : -FLT_MAX;
+        node.max_y[lane] = used ? bounds[lane].max.y : -FLT_MAX;
+        node.max_z[lane] = used ? bounds[lane].max.z : -FLT_MAX;
+        node.child[lane] = used ? children[lane] : 0;
+    }
+    return index;
+}
+
+template <typename Callback>
+void SceneQuery::traverse(const glm::vec3 &origin, const glm::vec3 &direction, float max_distance,
+                          const glm::vec3 &inflate, Callback &&callback) const {
+    if (m_nodes.empty())
+        return;
+    const glm::vec3 inverse = safe_inverse(direction);
+    int32_t stack[max_stack];
+    int size      = 0;
+    stack[size++] = 0;
+    while (size > 0) {
+        const Node &node = m_nodes[stack[--size]];
+        // Slab test of all lanes at once, written without branches on lane data so it vectorizes
+        alignas(32) float entry[node_width];
+        alignas(32) uint32_t hit[node_width];
+        for (size_t i = 0; i < node_width; ++i) {
+            const float tx0 = (node.min_x[i] - inflate.x - origin.x) * inverse.x;
+            const float tx1 = (node.max_x[i] + inflate.x - origin.x) * inverse.x;
+            const float ty0 = (node.min_y[i] - inflate.y - origin.y) * inverse.y;
+            const float ty1 = (node.max_y[i] + inflate.y - origin.y) * inverse.y;
+            const float tz0 = (node.min_z[i] - inflate.z - origin.z) * inverse.z;
+            const float tz1 = (node.max_z[i] + inflate.z - origin.z) * inverse.z;
+            const float t_near =
+                std::fmax(std::fmax(std::fmin(tx0, tx1), std::fmin(ty0, ty1)), std::fmax(std::fmin(tz0, tz1), 0.0f));
+            const float t_far = std::fmin(std::fmin(std::fmax(tx0, tx1), std::fmax(ty0, ty1)),
+                                          std::fmin(std::fmax(tz0, tz1), max_distance));
+            entry[i] = t_near;
+            hit[i]   = (t_near <= t_far) & (i < node.count);
+        }
+        // Push farther lanes first so nearer subtrees are visited, and prune the ray, early
+        int order[node_width];
+        int hits = 0;
+        for (int i = 0; i < static_cast<int>(node.count); ++i) {
+            if (hit[i])
+                order[hits++] = i;
+        }
+        std::sort(order, order + hits, [&](int a, int b) { return entry[a] > entry[b]; });
+        for (int i = 0; i < hits; ++i) {
+            const int32_t child = node.child[order[i]];
+            if (child >= 0)
+                stack[size++] = child;
+        }
+        for (int i = hits - 1; i >= 0; --i) {
+            const int32_t child = node.child[order[i]];
+            if (child < 0 && entry[order[i]] <= max_distance)
+                callback(static_cast<uint32_t>(~child), max_distance);
+        }
+    }
+}
+
+template <typename Callback> void SceneQuery::traverse(const AABB &aabb, Callback &&callback) const {
+    if (m_nodes.empty())
+        return;
+    int32_t stack[max_stack];
+    int size      = 0;
+    stack[size++] = 0;
+    while (size > 0) {
+        const Node &node = m_nodes[stack[--size]];
+        for (uint32_t i = 0; i < node.count; ++i) {
+            if (node.min_x[i] > aabb.max.x || node.max_x[i] < aabb.min.x || node.min_y[i] > aabb.max.y ||
+                node.max_y[i] < aabb.min.y || node.min_z[i] > aabb.max.z || node.max_z[i] < aabb.min.z)
+                continue;
+            if (node.child[i] >= 0)
+                stack[size++] = node.child[i];
+            else
+                callback(static_cast<uint32_t>(~node.child[i]));
+        }
+    }
+}
+
+template <typename Query, typename Test>
+void SceneQuery::run_batch(const std::vector<Query> &queries, Results &results, bool closest_only, Test &&test) {
+    auto pool           = get_thread_pool();
+    const size_t chunks = std::max<size_t>(pool->chunk_count(queries.size(), query_grain), 1);
+    results.chunk_hits.resize(chunks);
+    results.offsets.assign(queries.size() + 1, 0);
+    pool->parallel_for(queries.size(), query_grain, [&](size_t chunk, size_t begin, size_t end) {
+        auto &buffer = results.chunk_hits[chunk];
+        buffer.clear();
+        for (size_t i = begin; i < end; ++i) {
+            const size_t first = buffer.size();
+            test(queries[i], buffer);
+            std::sort(buffer.begin() + first, buffer.end(), [](const Hit &a, const Hit &b) {
+                return a.distance < b.distance;
+            });
+            if (closest_only && buffer.size() > first + 1)
+                buffer.resize(first + 1);
+            results.offsets[i + 1] = static_cast<uint32_t>(buffer.size() - first);
+        }
+    });
+    // Chunks cover contiguous query ranges in order, so concatenating them keeps the hits grouped by query
+    for (size_t i = 0; i < queries.size(); ++i)
+        results.offsets[i + 1] += results.offsets[i];
+    results.hits.clear();
+    results.hits.reserve(results.offsets.back());
+    for (size_t chunk = 0; chunk < chunks; ++chunk)
+        results.hits.insert(results.hits.end(), results.chunk_hits[chunk].begin(), results.chunk_hits[chunk].end());
+}
+
+void SceneQuery::raycast(const entt::registry &registry, const std::vector<Ray> &rays, Results &results,
+                         bool closest_only) const {
+    run_batch(rays, results, closest_only, [&](const Ray &ray, std::vector<Hit> &hits) {
+        const float length = glm::length(ray.direction);
+        if (length < epsilon)
+            return;
+        const glm::vec3 direction = ray.direction / length;
+        auto visit                = [&](uint32_t proxy, float &max_distance) {
+            if ((m_layers[proxy] & ray.mask) == 0)
+                return;
+            const entt::entity entity = m_entities[proxy];
+            // The snapshot is a step old, its entities may have been destroyed since
+            if (!registry.valid(entity) || !registry.all_of<Collider, ColliderCache>(entity))
+                return;
+            const auto &[collider, cache] = registry.get<Collider, ColliderCache>(entity);
+            float t;
+            glm::vec3 normal;
+            if (!ray_collider(collider, cache, ray.origin, direction, max_distance, t, normal))
+                return;
+            hits.push_back({ entity, t, ray.origin + direction * t, normal });
+            if (closest_only)
+                max_distance = t;
+        };
+        float max_distance = ray.max_distance;
+        for (const uint32_t proxy : m_unbounded)
+            visit(proxy, max_distance);
+        traverse(ray.origin, direction, max_distance, glm::vec3(0.0f), visit);
+    });
+}
+
+void SceneQuery::sweep(const entt::registry &registry, const std::vector<Sweep> &sweeps, Results &results,
+                       bool closest_only) const {
+    run_batch(sweeps, results, closest_only, [&](const Sweep &sweep, std::vector<Hit> &hits) {
+        const float length = glm::length(sweep.direction);
+        if (length < epsilon)
+            return;
+        const glm::vec3 direction = sweep.direction / length;
+        const glm::vec3 center    = (sweep.base + sweep.top) * 0.5f;
+        const glm::vec3 inflate   = glm::abs(sweep.top - sweep.base) * 0.5f + glm::vec3(sweep.radius);
+        const glm::vec3 inverse   = safe_inverse(direction);
+        Collider shape{};
+        if (glm::dot(sweep.top - sweep.base, sweep.top - sweep.base) > epsilon * epsilon) {
+            shape.shape          = Collider::CAPSULE;
+            shape.capsule_radius = sweep.radius;
+            shape.capsule_height = glm::length(sweep.top - sweep.base) + 2.0f * sweep.radius;
+        } else {
+            shape.shape  = Collider::SPHERE;
+            shape.radius = sweep.radius;
+        }
+        ColliderCache placed;
+        CollisionSystem::CollisionManifold manifold{};
+        auto visit = [&](uint32_t proxy, float &max_distance) {
+            if ((m_layers[proxy] & sweep.mask) == 0)
+                return;
+            const entt::entity entity = m_entities[proxy];
+            if (!registry.valid(entity) || !registry.all_of<Collider, ColliderCache>(entity))
+                return;
+            const auto &[collider, cache] = registry.get<Collider, ColliderCache>(entity);
+            if (collider.shape == Collider::PLANE) {
+                // Unbounded, solved directly for the lower end of the core segment
+                const glm::vec3 normal = cache.basis[1];
+                const float base_gap   = glm::dot(sweep.base - cache.center, normal);
+                const float top_gap    = glm::dot(sweep.top - cache.center, normal);
+                const float gap        = std::min(base_gap, top_gap) - sweep.radius;
+                const float speed      = glm::dot(direction, normal);
+                if (gap > 0.0f && speed >= 0.0f)
+                    return;
+                const float t = gap > 0.0f ? gap / -speed : 0.0f;
+                if (t > max_distance)
+                    return;
+                const glm::vec3 lowest = base_gap < top_gap ? sweep.base : sweep.top;
+                hits.push_back({ entity, t, lowest + direction * t - normal * sweep.radius, normal });
+                if (closest_only)
+                    max_distance = t;
+                return;
+            }
+            // Step through the part of the path where the bounds overlap, finely enough relative to the radius that
+            // only grazing contacts can be stepped over, then bisect between the last free and first touching position
+            float t_near, t_far;
+            slab(center, inverse, cache.aabb.min - inflate, cache.aabb.max + inflate, t_near, t_far);
+            t_near = std::max(t_near, 0.0f);
+            t_far  = std::min(t_far, max_distance);
+            if (t_near > t_far)
+                return;
+            const float span   = t_far - t_near;
+            const float needed = std::ceil(sweep_steps_per_radius * span / std::max(sweep.radius, epsilon));
+            const int steps    = static_cast<int>(std::clamp(needed, 1.0f, static_cast<float>(max_sweep_steps)));
+            float last_free = -1.0f, first_touch = -1.0f;
+            for (int i = 0; i <= steps; ++i) {
+                const float t = t_near + span * static_cast<float>(i) / static_cast<float>(steps);
+                place_swept_shape(sweep, direction, t, placed);
+                if (CollisionSystem::collide(shape, placed, collider, cache, manifold)) {
+                    first_touch = t;
+                    break;
+                }
+                last_free = t;
+            }
+            if (first_touch < 0.0f)
+                return;
+            // Touching at the first step means the shape starts inside the grown bounds and already overlaps
+            for (int i = 0; last_free >= 0.0f && i < sweep_refinements; ++i) {
+                const float t = (last_free + first_touch) * 0.5f;
+                place_swept_shape(sweep, direction, t, placed);
+                if (CollisionSystem::collide(shape, placed, collider, cache, manifold))
+                    first_touch = t;
+                else
+                    last_free = t;
+            }
+            place_swept_shape(sweep, direction, first_touch, placed);
+            if (!CollisionSystem::collide(shape, placed, collider, cache, manifold))
+                return;
+            hits.push_back({ entity, first_touch, manifold.contact_point, -manifold.normal });
+            if (closest_only)
+                max_distance = first_touch;
+        };
+        float max_distance = sweep.max_distance;
+        for (const uint32_t proxy : m_unbounded)
+            visit(proxy, max_distance);
+        traverse(center, direction, max_distance, inflate, visit);
+    });
+}
+
+void SceneQuery::overlap(const entt::registry &registry, const std::vector<Overlap> &shapes,
+                         Results &results) const {
+    run_batch(shapes, results, false, [&](const Overlap &shape, std::vector<Hit> &hits) {
+        ColliderCache placed;
+        placed.refresh(shape.transform, shape.collider);
+        CollisionSystem::CollisionManifold manifold{};
+        auto visit = [&](uint32_t proxy) {
+            if ((m_layers[proxy] & shape.collider.mask) == 0)
+                return;
+            const entt::entity entity = m_entities[proxy];
+            if (!registry.valid(entity) || !registry.all_of<Collider, ColliderCache>(entity))
+                return;
+            const auto &[collider, cache] = registry.get<Collider, ColliderCache>(entity);
+            if (!placed.aabb.overlaps(cache.aabb) ||
+                !CollisionSystem::collide(shape.collider, placed, collider, cache, manifold))
+                return;
+            hits.push_back({ entity, -manifold.penetration_depth, manifold.contact_point, -manifold.normal });
+        };
+        for (const uint32_t proxy : m_unbounded)
+            visit(proxy);
+        traverse(placed.aabb, visit);
+    });
+}
@@ -0,0 +1,7 @@
+#include <ecs/system/physics_subsystem/scene_query_system.h>
+
+int SceneQuerySystem::execution_priority() const { return priority; }
+
+void SceneQuerySystem::update(entt::registry &registry, float dt) {
+    registry.ctx().emplace<SceneQuery>().rebuild(registry);
+}
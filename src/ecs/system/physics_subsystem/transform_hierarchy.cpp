@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <core/fwd.h>
+#include <core/parallel/thread_pool.h>
+#include <ecs/system/physics_subsystem/transform_hierarchy.h>
+
+void TransformHierarchy::update(entt::registry &registry) {
+    current_links.clear();
+    registry.view<Transform>().each([&](auto entity, const Transform &t) {
+        if (t.parent == entt::null)
+            return;
+        // A missing parent turns the child into a root until the link is changed
+        const bool exists = t.parent != entity && registry.valid(t.parent) && registry.all_of<Transform>(t.parent);
+        current_links.push_back({ entity, exists ? t.parent : entt::null });
+    });
+    std::sort(current_links.begin(), current_links.end(),
+              [](const Link &lhs, const Link &rhs) { return lhs.child < rhs.child; });
+    if (current_links != links) {
+        links.swap(current_links);
+        rebuild();
+    }
+    propagate(registry);
+}
+
+void TransformHierarchy::propagate(entt::registry &registry) {
+    get_thread_pool()->parallel_for(trees.size(), propagate_grain, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            propagate_tree(registry, trees[i]);
+    });
+}
+
+void TransformHierarchy::rebuild() {
+    nodes.clear();
+    trees.clear();
+    std::vector<Link> by_parent;
+    for (const auto &link : links) {
+        if (link.parent != entt::null)
+            by_parent.push_back(link);
+    }
+    std::sort(by_parent.begin(), by_parent.end(), [](const Link &lhs, const Link &rhs) {
+        return lhs.parent != rhs.parent ? lhs.parent < rhs.parent : lhs.child < rhs.child;
+    });
+    auto has_parent = [&](entt::entity entity) {
+        const auto it = std::lower_bound(links.begin(), links.end(), entity,
+                                         [](const Link &link, entt::entity value) { return link.child < value; });
+        return it != links.end() && it->child == entity && it->parent != entt::null;
+    };
+    // Roots are parents without a parent of their own, and children whose parent is gone
+    std::vector<entt::entity> roots;
+    for (const auto &link : by_parent) {
+        if (!has_parent(link.parent) && (roots.empty() || roots.back() != link.parent))
+            roots.push_back(link.parent);
+    }
+    for (const auto &link : links) {
+        if (link.parent == entt::null)
+            roots.push_back(link.child);
+    }
+    std::sort(roots.begin(), roots.end());
+    roots.erase(std::unique(roots.begin(), roots.end()), roots.end());
+    // Breadth-first from each root keeps every tree contiguous with parents first
+    for (const auto root : roots) {
+        const auto begin = static_cast<uint32_t>(nodes.size());
+        nodes.push_back({ root, UINT32_MAX, stale_version });
+        for (auto i = begin; i < nodes.size(); ++i) {
+            const entt::entity entity = nodes[i].entity;
+            auto it = std::lower_bound(by_parent.begin(), by_parent.end(), entity,
+                                       [](const Link &link, entt::entity value) { return link.parent < value; });
+            for (; it != by_parent.end() && it->parent == entity; ++it)
+                nodes.push_back({ it->child, i, stale_version });
+        }
+        trees.push_back({ begin, static_cast<uint32_t>(nodes.size()) });
+    }
+    // Every linked child is reached from a root unless its links loop back on themselves
+    if (nodes.size() - roots.size() < by_parent.size())
+        get_logger()->error("[TransformHierarchy] Parent links form a cycle, the entities on it are ignored");
+    worlds.resize(nodes.size());
+    inverses.resize(nodes.size());
+    changed.resize(nodes.size());
+}
+
+void TransformHierarchy::propagate_tree(entt::registry &registry, const Tree &tree) {
+    for (uint32_t i = tree.begin; i < tree.end; ++i) {
+        Node &node         = nodes[i];
+        auto &t            = registry.get<Transform>(node.entity);
+        const auto version = t.get_version();
+        const bool is_root = node.parent == UINT32_MAX;
+        changed[i]         = version != node.local_version || (!is_root && changed[node.parent]);
+        if (!changed[i])
+            continue;
+        node.local_version = version;
+        if (is_root) {
+            worlds[i]   = t.matrix();
+            inverses[i] = t.inverse_matrix();
+        } else {
+            worlds[i]   = worlds[node.parent] * t.matrix();
+            inverses[i] = t.inverse_matrix() * inverses[node.parent];
+        }
+        // Roots without a parent link read their local matrices directly
+        if (t.parent != entt::null) {
+            t.m_world_matrix         = worlds[i];
+            t.m_world_inverse_matrix = inverses[i];
+            ++t.m_world_changes;
+        }
+    }
+}
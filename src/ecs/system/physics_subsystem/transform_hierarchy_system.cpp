@@ -0,0 +1,7 @@
+#include <ecs/system/physics_subsystem/transform_hierarchy_system.h>
+
+int TransformHierarchySystem::execution_priority() const { return priority; }
+
+void TransformHierarchySystem::update(entt::registry &registry, float dt) {
+    registry.ctx().emplace<TransformHierarchy>().update(registry);
+}
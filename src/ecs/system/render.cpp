@@ -2,6 +2,7 @@
 
 #include <ecs/component/cloth.h>
 #include <ecs/component/collider.h>
+#include <ecs/component/groups.h>
 #include <ecs/component/transform.h>
 #include <ecs/system/render.h>
 #include <glm/ext/matrix_transform.hpp>
@@ -27,14 +28,16 @@ void RenderSystem::draw_scene(entt::registry &registry, const std::shared_ptr<Sc
     shader->set_matrix4("uView", view);
     shader->set_matrix4("uProjection", proj);
 
-    // Draw colliders in wireframe mode
+    // Draw colliders in wireframe mode. A view rather than collider_group, which only holds colliders that already
+    // have a cache, i.e. none before the first physics step or without ColliderCacheSystem.
     auto collider_view = registry.view<const Transform, const Collider>();
     collider_view.each([&](const auto &transform, const auto &collider) {
-        if (collider.visualize) {
+        // Shapes without a wireframe, e.g. a distance field without data, leave the model empty
+        if (collider.visualize && collider.visualize_model) {
             // Enable polygon mode for wireframe rendering
             glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
-            shader->set_matrix4("uModel", glm::translate(transform.matrix(), collider.offset));
+            shader->set_matrix4("uModel", glm::translate(transform.world_matrix(), collider.offset));
             draw_mesh(collider.visualize_model->get_meshes(), shader);
 
             // Reset polygon mode to fill after drawing colliders
@@ -49,7 +52,7 @@ void RenderSystem::draw_scene(entt::registry &registry, const std::shared_ptr<Sc
             // Enable polygon mode for wireframe rendering
             glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
-            shader->set_matrix4("uModel", transform.matrix());
+            shader->set_matrix4("uModel", transform.world_matrix());
             draw_mesh(cloth.model->get_meshes(), shader);
 
             // Reset polygon mode to fill after drawing colliders
@@ -58,13 +61,12 @@ void RenderSystem::draw_scene(entt::registry &registry, const std::shared_ptr<Sc
     });
 
     // Draw all renderable entities
-    auto render_view = registry.view<const Transform, const Renderable>();
-    render_view.each([&](const auto &transform, const auto &renderable) {
+    each_renderable(registry, [&](const auto &renderable, const auto &transform) {
         if (renderable.mode == Renderable::polygon) {
             glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
         }
 
-        shader->set_matrix4("uModel", transform.matrix());
+        shader->set_matrix4("uModel", transform.world_matrix());
         draw_mesh(renderable.model->get_meshes(), shader);
 
         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
@@ -0,0 +1,249 @@
+#include <algorithm>
+#include <cfloat>
+#include <scene/model/convex_hull.h>
+#include <scene/model/model.h>
+#include <unordered_map>
+
+namespace {
+struct BuildFace {
+    uint32_t indices[3];
+    glm::vec3 normal;
+    float offset;
+    std::vector<uint32_t> outside; // Points in front of the face that are not assigned to another face
+    bool alive   = true;
+    bool visible = false;
+};
+
+uint64_t edge_key(uint32_t from, uint32_t to) { return static_cast<uint64_t>(from) << 32 | to; }
+} // namespace
+
+std::shared_ptr<ConvexHull> ConvexHull::build(const std::vector<glm::vec3> &points) {
+    if (points.size() < 4)
+        return nullptr;
+    // Tolerance relative to the size of the input
+    glm::vec3 max_abs(0.0f);
+    uint32_t extremes[6] = {};
+    for (uint32_t i = 0; i < points.size(); ++i) {
+        max_abs = glm::max(max_abs, glm::abs(points[i]));
+        for (int axis = 0; axis < 3; ++axis) {
+            if (points[i][axis] < points[extremes[axis * 2]][axis])
+                extremes[axis * 2] = i;
+            if (points[i][axis] > points[extremes[axis * 2 + 1]][axis])
+                extremes[axis * 2 + 1] = i;
+        }
+    }
+    const float epsilon = 3.0f * FLT_EPSILON * (max_abs.x + max_abs.y + max_abs.z);
+
+    // Initial tetrahedron: the most distant extreme pair, then the furthest points from its line and plane
+    uint32_t v0 = 0, v1 = 0;
+    float max_distance = -1.0f;
+    for (const uint32_t a : extremes) {
+        for (const uint32_t b : extremes) {
+            const glm::vec3 d = points[b] - points[a];
+            if (glm::dot(d, d) > max_distance) {
+                max_distance = glm::dot(d, d);
+                v0           = a;
+                v1           = b;
+            }
+        }
+    }
+    const glm::vec3 line = glm::normalize(points[v1] - points[v0]);
+    uint32_t v2          = v0;
+    max_distance         = epsilon;
+    for (uint32_t i = 0; i < points.size(); ++i) {
+        const glm::vec3 d      = points[i] - points[v0];
+        const float distance   = glm::length(d - glm::dot(d, line) * line);
+        if (distance > max_distance) {
+            max_distance = distance;
+            v2           = i;
+        }
+    }
+    if (v2 == v0)
+        return nullptr;
+    const glm::vec3 base_normal = glm::normalize(glm::cross(points[v1] - points[v0], points[v2] - points[v0]));
+    uint32_t v3                 = v0;
+    max_distance                = epsilon;
+    for (uint32_t i = 0; i < points.size(); ++i) {
+        const float distance = std::abs(glm::dot(points[i] - points[v0], base_normal));
+        if (distance > max_distance) {
+            max_distance = distance;
+            v3           = i;
+        }
+    }
+    if (v3 == v0)
+        return nullptr;
+
+    std::vector<BuildFace> faces;
+    std::unordered_map<uint64_t, uint32_t> edge_faces; // Directed edge -> face owning it
+    auto add_face = [&](uint32_t a, uint32_t b, uint32_t c) {
+        BuildFace face;
+        face.indices[0] = a;
+        face.indices[1] = b;
+        face.indices[2] = c;
+        face.normal     = glm::normalize(glm::cross(points[b] - points[a], points[c] - points[a]));
+        face.offset     = glm::dot(face.normal, points[a]);
+        const auto id   = static_cast<uint32_t>(faces.size());
+        for (int e = 0; e < 3; ++e)
+            edge_faces[edge_key(face.indices[e], face.indices[(e + 1) % 3])] = id;
+        faces.push_back(std::move(face));
+        return id;
+    };
+    // Wind the tetrahedron so that its faces point away from the opposite vertex
+    if (glm::dot(points[v3] - points[v0], base_normal) > 0.0f)
+        std::swap(v1, v2);
+    add_face(v0, v1, v2);
+    add_face(v0, v3, v1);
+    add_face(v1, v3, v2);
+    add_face(v2, v3, v0);
+
+    // Each remaining point goes to the face it is furthest in front of
+    auto assign = [&](uint32_t point, const std::vector<uint32_t> &candidates) {
+        float best_distance = epsilon;
+        uint32_t best_face  = UINT32_MAX;
+        for (const uint32_t f : candidates) {
+            const float distance = glm::dot(faces[f].normal, points[point]) - faces[f].offset;
+            if (distance > best_distance) {
+                best_distance = distance;
+                best_face     = f;
+            }
+        }
+        if (best_face != UINT32_MAX)
+            faces[best_face].outside.push_back(point);
+    };
+    const std::vector<uint32_t> initial_faces = { 0, 1, 2, 3 };
+    for (uint32_t i = 0; i < points.size(); ++i) {
+        if (i != v0 && i != v1 && i != v2 && i != v3)
+            assign(i, initial_faces);
+    }
+
+    std::vector<uint32_t> stack, visible, new_faces, orphans;
+    std::vector<std::pair<uint32_t, uint32_t>> horizon;
+    for (uint32_t current = 0; current < faces.size(); ++current) {
+        if (!faces[current].alive || faces[current].outside.empty())
+            continue;
+        // Eye point: the furthest outside point of this face
+        uint32_t eye        = faces[current].outside.front();
+        float eye_distance  = -FLT_MAX;
+        for (const uint32_t p : faces[current].outside) {
+            const float distance = glm::dot(faces[current].normal, points[p]) - faces[current].offset;
+            if (distance > eye_distance) {
+                eye_distance = distance;
+                eye          = p;
+            }
+        }
+        // Flood the connected set of faces the eye can see
+        visible.clear();
+        stack.assign(1, current);
+        faces[current].visible = true;
+        while (!stack.empty()) {
+            const uint32_t f = stack.back();
+            stack.pop_back();
+            visible.push_back(f);
+            for (int e = 0; e < 3; ++e) {
+                const auto it = edge_faces.find(edge_key(faces[f].indices[(e + 1) % 3], faces[f].indices[e]));
+                if (it == edge_faces.end())
+                    continue;
+                auto &neighbor = faces[it->second];
+                if (neighbor.visible || glm::dot(neighbor.normal, points[eye]) - neighbor.offset <= epsilon)
+                    continue;
+                neighbor.visible = true;
+                stack.push_back(it->second);
+            }
+        }
+        // Horizon: edges of visible faces whose neighbor stays
+        horizon.clear();
+        orphans.clear();
+        for (const uint32_t f : visible) {
+            for (int e = 0; e < 3; ++e) {
+                const uint32_t from = faces[f].indices[e];
+                const uint32_t to   = faces[f].indices[(e + 1) % 3];
+                const auto it       = edge_faces.find(edge_key(to, from));
+                if (it == edge_faces.end() || !faces[it->second].visible)
+                    horizon.emplace_back(from, to);
+            }
+            orphans.insert(orphans.end(), faces[f].outside.begin(), faces[f].outside.end());
+        }
+        for (const uint32_t f : visible) {
+            for (int e = 0; e < 3; ++e)
+                edge_faces.erase(edge_key(faces[f].indices[e], faces[f].indices[(e + 1) % 3]));
+            faces[f].alive   = false;
+            faces[f].visible = false;
+            faces[f].outside.clear();
+            faces[f].outside.shrink_to_fit();
+        }
+        // Cone from the horizon to the eye, then hand the orphaned points to the new faces
+        new_faces.clear();
+        for (const auto &[from, to] : horizon)
+            new_faces.push_back(add_face(from, to, eye));
+        for (const uint32_t p : orphans) {
+            if (p != eye)
+                assign(p, new_faces);
+        }
+    }
+
+    // Compact the surviving faces and the vertices they use
+    auto hull = std::make_shared<ConvexHull>();
+    std::unordered_map<uint32_t, uint32_t> remap;
+    for (const auto &face : faces) {
+        if (!face.alive)
+            continue;
+        Face out{};
+        for (int k = 0; k < 3; ++k) {
+            const auto [it, inserted] = remap.try_emplace(face.indices[k], static_cast<uint32_t>(remap.size()));
+            if (inserted)
+                hull->m_vertices.push_back(points[face.indices[k]]);
+            out.indices[k] = it->second;
+        }
+        out.normal = face.normal;
+        out.offset = face.offset;
+        hull->m_faces.push_back(out);
+    }
+    // Every directed edge belongs to exactly one face, so each neighbor is recorded once per vertex
+    const size_t vertex_count = hull->m_vertices.size();
+    hull->m_adjacency_offsets.assign(vertex_count + 1, 0);
+    for (const auto &face : hull->m_faces) {
+        for (const uint32_t index : face.indices)
+            ++hull->m_adjacency_offsets[index + 1];
+    }
+    for (size_t i = 0; i < vertex_count; ++i)
+        hull->m_adjacency_offsets[i + 1] += hull->m_adjacency_offsets[i];
+    hull->m_adjacency.resize(hull->m_adjacency_offsets.back());
+    std::vector<uint32_t> fill(hull->m_adjacency_offsets.begin(), hull->m_adjacency_offsets.end() - 1);
+    for (const auto &face : hull->m_faces) {
+        for (int e = 0; e < 3; ++e)
+            hull->m_adjacency[fill[face.indices[e]]++] = face.indices[(e + 1) % 3];
+    }
+    return hull;
+}
+
+std::shared_ptr<ConvexHull> ConvexHull::from_model(const Model &model) {
+    std::vector<glm::vec3> points;
+    for (const auto &mesh : model.get_meshes()) {
+        for (const auto &vertex : mesh->get_vertices())
+            points.push_back(vertex.position);
+    }
+    return build(points);
+}
+
+uint32_t ConvexHull::support(const glm::vec3 &direction, uint32_t start) const noexcept {
+    uint32_t best  = start < m_vertices.size() ? start : 0;
+    float best_dot = glm::dot(m_vertices[best], direction);
+    // On a convex polytope every local maximum of a linear function is global
+    for (bool improved = true; improved;) {
+        improved             = false;
+        const uint32_t vertex = best;
+        for (uint32_t k = m_adjacency_offsets[vertex]; k < m_adjacency_offsets[vertex + 1]; ++k) {
+            const float d = glm::dot(m_vertices[m_adjacency[k]], direction);
+            if (d > best_dot) {
+                best_dot = d;
+                best     = m_adjacency[k];
+                improved = true;
+            }
+        }
+    }
+    return best;
+}
+
+const std::vector<glm::vec3> &ConvexHull::get_vertices() const noexcept { return m_vertices; }
+
+const std::vector<ConvexHull::Face> &ConvexHull::get_faces() const noexcept { return m_faces; }
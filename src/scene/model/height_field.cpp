@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <core/fwd.h>
+#include <scene/model/height_field.h>
+#include <scene/model/triangle_mesh_bvh.h>
+#include <scene/texture/texture_manager.h>
+
+std::shared_ptr<HeightField> HeightField::build(std::vector<float> heights, int columns, int rows,
+                                                const glm::vec3 &size) {
+    if (columns < 2 || rows < 2 || heights.size() != static_cast<size_t>(columns) * rows)
+        return nullptr;
+    auto field         = std::make_shared<HeightField>();
+    field->m_columns   = columns;
+    field->m_rows      = rows;
+    field->m_cell_size = glm::vec2(size.x / static_cast<float>(columns - 1), size.z / static_cast<float>(rows - 1));
+    field->m_origin    = -glm::vec2(size.x, size.z) * 0.5f;
+    field->m_heights   = std::move(heights);
+    for (auto &height : field->m_heights)
+        height *= size.y;
+    // Cell ranges first, then merge 2x2 blocks until one block covers the grid
+    Level cells{ columns - 1, rows - 1, {} };
+    cells.range.resize(static_cast<size_t>(cells.columns) * cells.rows);
+    for (int row = 0; row < cells.rows; ++row) {
+        for (int column = 0; column < cells.columns; ++column) {
+            const float h00 = field->m_heights[row * columns + column];
+            const float h10 = field->m_heights[row * columns + column + 1];
+            const float h01 = field->m_heights[(row + 1) * columns + column];
+            const float h11 = field->m_heights[(row + 1) * columns + column + 1];
+            cells.range[row * cells.columns + column] =
+                glm::vec2(std::min({ h00, h10, h01, h11 }), std::max({ h00, h10, h01, h11 }));
+        }
+    }
+    field->m_levels.push_back(std::move(cells));
+    while (field->m_levels.back().columns > 1 || field->m_levels.back().rows > 1) {
+        const Level &below = field->m_levels.back();
+        Level level{ (below.columns + 1) / 2, (below.rows + 1) / 2, {} };
+        level.range.assign(static_cast<size_t>(level.columns) * level.rows, glm::vec2(FLT_MAX, -FLT_MAX));
+        for (int row = 0; row < below.rows; ++row) {
+            for (int column = 0; column < below.columns; ++column) {
+                auto &range       = level.range[(row / 2) * level.columns + column / 2];
+                const auto &child = below.range[row * below.columns + column];
+                range             = glm::vec2(std::min(range.x, child.x), std::max(range.y, child.y));
+            }
+        }
+        field->m_levels.push_back(std::move(level));
+    }
+    return field;
+}
+
+std::shared_ptr<HeightField> HeightField::from_texture(const Texture &texture, const glm::vec3 &size) {
+    if (!texture.exist_data())
+        return nullptr;
+    const int columns = texture.get_width(), rows = texture.get_height();
+    std::vector<float> heights(static_cast<size_t>(std::max(columns, 0)) * std::max(rows, 0));
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column)
+            heights[row * columns + column] = texture(row, column, 0);
+    }
+    return build(std::move(heights), columns, rows, size);
+}
+
+std::shared_ptr<HeightField> HeightField::from_file(const std::filesystem::path &path, const glm::vec3 &size) {
+    const auto texture = std::dynamic_pointer_cast<Texture>(get_texture_manager()->load_resource(path, {}));
+    if (!texture) {
+        get_logger()->error("[HeightField] No such height map: " + path.string());
+        return nullptr;
+    }
+    auto field = from_texture(*texture, size);
+    if (!field)
+        get_logger()->error("[HeightField] Height map needs at least 2x2 texels: " + path.string());
+    return field;
+}
+
+bool HeightField::height_at(float x, float z, float &height, glm::vec3 &normal) const noexcept {
+    const float fx = (x - m_origin.x) / m_cell_size.x;
+    const float fz = (z - m_origin.y) / m_cell_size.y;
+    if (!(fx >= 0.0f && fz >= 0.0f && fx <= static_cast<float>(m_columns - 1) &&
+          fz <= static_cast<float>(m_rows - 1)))
+        return false;
+    const int column = std::min(static_cast<int>(fx), m_columns - 2);
+    const int row    = std::min(static_cast<int>(fz), m_rows - 2);
+    const float u = fx - static_cast<float>(column), v = fz - static_cast<float>(row);
+    const glm::vec3 p00 = sample(column, row), p10 = sample(column + 1, row);
+    const glm::vec3 p01 = sample(column, row + 1), p11 = sample(column + 1, row + 1);
+    // Same diagonal split as get_triangle
+    if (v >= u) {
+        height = p00.y + v * (p01.y - p00.y) + u * (p11.y - p01.y);
+        normal = glm::normalize(glm::cross(p01 - p00, p11 - p00));
+    } else {
+        height = p00.y + u * (p10.y - p00.y) + v * (p11.y - p10.y);
+        normal = glm::normalize(glm::cross(p11 - p00, p10 - p00));
+    }
+    return true;
+}
+
+bool HeightField::raycast(const glm::vec3 &origin, const glm::vec3 &direction, float max_distance, float &distance,
+                          uint32_t &triangle) const noexcept {
+    glm::vec3 inverse;
+    for (int i = 0; i < 3; ++i)
+        inverse[i] = 1.0f / (std::abs(direction[i]) > 1e-12f ? direction[i] : std::copysign(1e-12f, direction[i]));
+    distance = max_distance;
+    // Entry distance of the ray into a block, or a negative value if it misses or enters past the closest hit
+    auto enter = [&](const Block &block) {
+        glm::vec3 min, max;
+        block_bounds(block, min, max);
+        const glm::vec3 t0 = (min - origin) * inverse;
+        const glm::vec3 t1 = (max - origin) * inverse;
+        const glm::vec3 lo = glm::min(t0, t1), hi = glm::max(t0, t1);
+        const float t_min  = std::max(std::max(lo.x, lo.y), std::max(lo.z, 0.0f));
+        const float t_max  = std::min(std::min(hi.x, hi.y), std::min(hi.z, distance));
+        return t_min <= t_max ? t_min : -1.0f;
+    };
+    bool hit = false;
+    Block stack[4 * max_levels];
+    int size      = 0;
+    stack[size++] = { static_cast<int>(m_levels.size()) - 1, 0, 0 };
+    while (size > 0) {
+        // Checked again on the way out, a hit may have shortened the ray since the push
+        const Block block = stack[--size];
+        if (enter(block) < 0.0f)
+            continue;
+        if (block.level == 0) {
+            const auto cell = static_cast<uint32_t>(block.row * (m_columns - 1) + block.column);
+            for (const uint32_t candidate : { cell * 2, cell * 2 + 1 }) {
+                const auto [v0, v1, v2] = get_triangle(candidate);
+                float t;
+                if (TriangleMeshBVH::intersect_triangle(origin, direction, v0, v1, v2, t) && t < distance) {
+                    distance = t;
+                    triangle = candidate;
+                    hit      = true;
+                }
+            }
+            continue;
+        }
+        // Push the children the ray enters, farthest first so the nearest one is walked next
+        Block children[4];
+        float entries[4];
+        int count          = 0;
+        const Level &below = m_levels[block.level - 1];
+        for (int row = block.row * 2; row < std::min(block.row * 2 + 2, below.rows); ++row) {
+            for (int column = block.column * 2; column < std::min(block.column * 2 + 2, below.columns); ++column) {
+                const Block child = { block.level - 1, column, row };
+                const float entry = enter(child);
+                if (entry < 0.0f)
+                    continue;
+                int slot = count++;
+                for (; slot > 0 && entries[slot - 1] < entry; --slot) {
+                    children[slot] = children[slot - 1];
+                    entries[slot]  = entries[slot - 1];
+                }
+                children[slot] = child;
+                entries[slot]  = entry;
+            }
+        }
+        for (int i = 0; i < count; ++i)
+            stack[size++] = children[i];
+    }
+    return hit;
+}
+
+std::array<glm::vec3, 3> HeightField::get_triangle(uint32_t triangle) const noexcept {
+    const uint32_t cell = triangle / 2;
+    const int column    = static_cast<int>(cell % static_cast<uint32_t>(m_columns - 1));
+    const int row       = static_cast<int>(cell / static_cast<uint32_t>(m_columns - 1));
+    // Cells are split along the diagonal from the first to the last corner
+    if (triangle % 2 == 0)
+        return { sample(column, row), sample(column, row + 1), sample(column + 1, row + 1) };
+    return { sample(column, row), sample(column + 1, row + 1), sample(column + 1, row) };
+}
+
+glm::vec3 HeightField::get_bounds_min() const noexcept {
+    return { m_origin.x, m_levels.back().range.front().x, m_origin.y };
+}
+
+glm::vec3 HeightField::get_bounds_max() const noexcept {
+    return { m_origin.x + m_cell_size.x * static_cast<float>(m_columns - 1), m_levels.back().range.front().y,
+             m_origin.y + m_cell_size.y * static_cast<float>(m_rows - 1) };
+}
+
+int HeightField::get_columns() const noexcept { return m_columns; }
+
+int HeightField::get_rows() const noexcept { return m_rows; }
+
+glm::vec3 HeightField::sample(int column, int row) const noexcept {
+    return { m_origin.x + m_cell_size.x * static_cast<float>(column), m_heights[row * m_columns + column],
+             m_origin.y + m_cell_size.y * static_cast<float>(row) };
+}
+
+void HeightField::block_bounds(const Block &block, glm::vec3 &min, glm::vec3 &max) const noexcept {
+    const int first_column = block.column << block.level;
+    const int first_row    = block.row << block.level;
+    const int last_column  = std::min((block.column + 1) << block.level, m_columns - 1);
+    const int last_row     = std::min((block.row + 1) << block.level, m_rows - 1);
+    const glm::vec2 &range = m_levels[block.level].range[block.row * m_levels[block.level].columns + block.column];
+    min = { m_origin.x + m_cell_size.x * static_cast<float>(first_column), range.x,
+            m_origin.y + m_cell_size.y * static_cast<float>(first_row) };
+    max = { m_origin.x + m_cell_size.x * static_cast<float>(last_column), range.y,
+            m_origin.y + m_cell_size.y * static_cast<float>(last_row) };
+}
@@ -179,6 +179,66 @@ std::shared_ptr<Resource> ModelManager::get_resource(const std::filesystem::path
     return it->second.model;
 }
 
+std::shared_ptr<ConvexHull> ModelManager::get_convex_hull(const std::filesystem::path &path) {
+    if (!load_resource(path, {}))
+        return nullptr;
+    std::lock_guard lock(m_mutex);
+    auto [resolved_path, exist] = get_file_resolver().resolve(path);
+    auto key                    = exist ? canonical(resolved_path).string() : path.string();
+    auto it                     = m_model_map.find(key);
+    if (it == m_model_map.end() || !it->second.model) {
+        get_logger()->error("[ModelManager] No such model: " + key);
+        return nullptr;
+    }
+    auto &record = it->second;
+    if (!record.convex_hull) {
+        record.convex_hull = ConvexHull::from_model(*record.model);
+        if (!record.convex_hull)
+            get_logger()->error("[ModelManager] Model is too flat for a convex hull: " + key);
+    }
+    return record.convex_hull;
+}
+
+std::shared_ptr<TriangleMeshBVH> ModelManager::get_triangle_mesh(const std::filesystem::path &path) {
+    if (!load_resource(path, {}))
+        return nullptr;
+    std::lock_guard lock(m_mutex);
+    auto [resolved_path, exist] = get_file_resolver().resolve(path);
+    auto key                    = exist ? canonical(resolved_path).string() : path.string();
+    auto it                     = m_model_map.find(key);
+    if (it == m_model_map.end() || !it->second.model) {
+        get_logger()->error("[ModelManager] No such model: " + key);
+        return nullptr;
+    }
+    auto &record = it->second;
+    if (!record.triangle_mesh) {
+        record.triangle_mesh = TriangleMeshBVH::from_model(*record.model);
+        if (!record.triangle_mesh)
+            get_logger()->error("[ModelManager] Model has no triangles: " + key);
+    }
+    return record.triangle_mesh;
+}
+
+std::shared_ptr<SignedDistanceField> ModelManager::get_signed_distance_field(const std::filesystem::path &path) {
+    if (!load_resource(path, {}))
+        return nullptr;
+    std::lock_guard lock(m_mutex);
+    auto [resolved_path, exist] = get_file_resolver().resolve(path);
+    auto key                    = exist ? canonical(resolved_path).string() : path.string();
+    auto it                     = m_model_map.find(key);
+    if (it == m_model_map.end() || !it->second.model) {
+        get_logger()->error("[ModelManager] No such model: " + key);
+        return nullptr;
+    }
+    auto &record = it->second;
+    if (!record.signed_distance_field) {
+        record.signed_distance_field = SignedDistanceField::from_model(*record.model);
+        if (!record.signed_distance_field)
+            get_logger()->error("[ModelManager] Model has no triangles: " + key);
+    }
+    return record.signed_distance_field;
+}
+
 void ModelManager::enable_hot_reload(bool enable, std::chrono::seconds interval) {
     if (enable) {
         if (m_hot_reload_thread.joinable()) {
@@ -235,6 +295,9 @@ void ModelManager::hot_reload_thread_func(std::chrono::seconds interval) {
                         if (it2 != m_model_map.end()) {
                             it2->second.model       = new_model;
                             it2->second.last_access = std::chrono::system_clock::now();
+                            it2->second.convex_hull.reset();
+                            it2->second.triangle_mesh.reset();
+                            it2->second.signed_distance_field.reset();
 
                             std::error_code ec2;
                             auto file_time2 = std::filesystem::last_write_time(filename, ec2);
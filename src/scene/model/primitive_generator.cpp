@@ -1,4 +1,7 @@
+#include <scene/model/convex_hull.h>
+#include <scene/model/height_field.h>
 #include <scene/model/primitive_generator.h>
+#include <scene/model/triangle_mesh_bvh.h>
 #include <scene/texture/texture.h>
 
 std::shared_ptr<Model> PrimitiveGenerator::generate_cube(const std::unordered_map<std::string, std::any> &params) {
@@ -384,6 +387,154 @@ std::shared_ptr<Model> PrimitiveGenerator::generate_capsule(const std::unordered
     return std::make_shared<Model>("internal://primitive/capsule", std::vector{ mesh });
 }
 
+std::shared_ptr<Model>
+PrimitiveGenerator::generate_convex_hull(const std::unordered_map<std::string, std::any> &params) {
+    // Param
+    const auto hull =
+        params.contains("hull") ? std::any_cast<std::shared_ptr<ConvexHull>>(params.at("hull")) : nullptr;
+    if (!hull) {
+        get_logger()->error("Convex hull primitive requires a hull");
+        return nullptr;
+    }
+    std::vector<Vertex> vertices;
+    std::vector<GLuint> indices;
+    std::vector<std::shared_ptr<Texture>> textures;
+
+    // Texture
+    try {
+        if (params.contains("material")) {
+            const auto &material = std::any_cast<std::unordered_map<std::string, std::any>>(params.at("material"));
+            const auto color_r   = material.contains("color_r") ? std::any_cast<float>(material.at("color_r")) : 1.0f;
+            const auto color_g   = material.contains("color_g") ? std::any_cast<float>(material.at("color_g")) : 1.0f;
+            const auto color_b   = material.contains("color_b") ? std::any_cast<float>(material.at("color_b")) : 1.0f;
+            const auto color_a   = material.contains("color_a") ? std::any_cast<float>(material.at("color_a")) : 1.0f;
+            const auto type = material.contains("type") ? std::any_cast<TextureType>(material.at("type")) : EDiffuse;
+            textures.push_back(Texture::create_solid_color(color_r, color_g, color_b, color_a, type));
+        } else {
+            textures.push_back(Texture::create_solid_color(1.0f, 1.0f, 1.0f, 1.0f, EDiffuse));
+        }
+    } catch (const std::bad_any_cast &e) {
+        get_logger()->error(std::string("Invalid material parameters: ") + e.what());
+    }
+
+    // Flat shaded, every face gets its own vertices
+    const auto &hull_vertices = hull->get_vertices();
+    for (const auto &face : hull->get_faces()) {
+        for (const uint32_t index : face.indices) {
+            Vertex vert;
+            vert.position       = hull_vertices[index];
+            vert.normal         = face.normal;
+            vert.texture_coords = glm::vec2(0.0f);
+            indices.push_back(static_cast<GLuint>(vertices.size()));
+            vertices.push_back(vert);
+        }
+    }
+
+    calculate_tangents(vertices, indices);
+    auto mesh = std::make_shared<Mesh>(vertices, indices, textures);
+    return std::make_shared<Model>("internal://primitive/convex_hull", std::vector{ mesh });
+}
+
+std::shared_ptr<Model>
+PrimitiveGenerator::generate_triangle_mesh(const std::unordered_map<std::string, std::any> &params) {
+    // Param
+    const auto triangle_mesh =
+        params.contains("mesh") ? std::any_cast<std::shared_ptr<TriangleMeshBVH>>(params.at("mesh")) : nullptr;
+    if (!triangle_mesh) {
+        get_logger()->error("Triangle mesh primitive requires a mesh");
+        return nullptr;
+    }
+    std::vector<Vertex> vertices;
+    std::vector<GLuint> indices;
+    std::vector<std::shared_ptr<Texture>> textures;
+
+    // Texture
+    try {
+        if (params.contains("material")) {
+            const auto &material = std::any_cast<std::unordered_map<std::string, std::any>>(params.at("material"));
+            const auto color_r   = material.contains("color_r") ? std::any_cast<float>(material.at("color_r")) : 1.0f;
+            const auto color_g   = material.contains("color_g") ? std::any_cast<float>(material.at("color_g")) : 1.0f;
+            const auto color_b   = material.contains("color_b") ? std::any_cast<float>(material.at("color_b")) : 1.0f;
+            const auto color_a   = material.contains("color_a") ? std::any_cast<float>(material.at("color_a")) : 1.0f;
+            const auto type = material.contains("type") ? std::any_cast<TextureType>(material.at("type")) : EDiffuse;
+            textures.push_back(Texture::create_solid_color(color_r, color_g, color_b, color_a, type));
+        } else {
+            textures.push_back(Texture::create_solid_color(1.0f, 1.0f, 1.0f, 1.0f, EDiffuse));
+        }
+    } catch (const std::bad_any_cast &e) {
+        get_logger()->error(std::string("Invalid material parameters: ") + e.what());
+    }
+
+    // Flat shaded, every triangle gets its own vertices
+    for (uint32_t t = 0; t < triangle_mesh->get_triangle_count(); ++t) {
+        const auto corners     = triangle_mesh->get_triangle(t);
+        const glm::vec3 normal = glm::normalize(glm::cross(corners[1] - corners[0], corners[2] - corners[0]));
+        for (const auto &corner : corners) {
+            Vertex vert;
+            vert.position       = corner;
+            vert.normal         = normal;
+            vert.texture_coords = glm::vec2(0.0f);
+            indices.push_back(static_cast<GLuint>(vertices.size()));
+            vertices.push_back(vert);
+        }
+    }
+
+    calculate_tangents(vertices, indices);
+    auto mesh = std::make_shared<Mesh>(vertices, indices, textures);
+    return std::make_shared<Model>("internal://primitive/triangle_mesh", std::vector{ mesh });
+}
+
+std::shared_ptr<Model>
+PrimitiveGenerator::generate_height_field(const std::unordered_map<std::string, std::any> &params) {
+    // Param
+    const auto height_field =
+        params.contains("field") ? std::any_cast<std::shared_ptr<HeightField>>(params.at("field")) : nullptr;
+    if (!height_field) {
+        get_logger()->error("Height field primitive requires a field");
+        return nullptr;
+    }
+    std::vector<Vertex> vertices;
+    std::vector<GLuint> indices;
+    std::vector<std::shared_ptr<Texture>> textures;
+
+    // Texture
+    try {
+        if (params.contains("material")) {
+            const auto &material = std::any_cast<std::unordered_map<std::string, std::any>>(params.at("material"));
+            const auto color_r   = material.contains("color_r") ? std::any_cast<float>(material.at("color_r")) : 1.0f;
+            const auto color_g   = material.contains("color_g") ? std::any_cast<float>(material.at("color_g")) : 1.0f;
+            const auto color_b   = material.contains("color_b") ? std::any_cast<float>(material.at("color_b")) : 1.0f;
+            const auto color_a   = material.contains("color_a") ? std::any_cast<float>(material.at("color_a")) : 1.0f;
+            const auto type = material.contains("type") ? std::any_cast<TextureType>(material.at("type")) : EDiffuse;
+            textures.push_back(Texture::create_solid_color(color_r, color_g, color_b, color_a, type));
+        } else {
+            textures.push_back(Texture::create_solid_color(1.0f, 1.0f, 1.0f, 1.0f, EDiffuse));
+        }
+    } catch (const std::bad_any_cast &e) {
+        get_logger()->error(std::string("Invalid material parameters: ") + e.what());
+    }
+
+    // Flat shaded, every triangle gets its own vertices
+    const auto triangle_count =
+        static_cast<uint32_t>(2 * (height_field->get_columns() - 1) * (height_field->get_rows() - 1));
+    for (uint32_t t = 0; t < triangle_count; ++t) {
+        const auto corners     = height_field->get_triangle(t);
+        const glm::vec3 normal = glm::normalize(glm::cross(corners[1] - corners[0], corners[2] - corners[0]));
+        for (const auto &corner : corners) {
+            Vertex vert;
+            vert.position       = corner;
+            vert.normal         = normal;
+            vert.texture_coords = glm::vec2(0.0f);
+            indices.push_back(static_cast<GLuint>(vertices.size()));
+            vertices.push_back(vert);
+        }
+    }
+
+    calculate_tangents(vertices, indices);
+    auto mesh = std::make_shared<Mesh>(vertices, indices, textures);
+    return std::make_shared<Model>("internal://primitive/height_field", std::vector{ mesh });
+}
+
 std::shared_ptr<Model> PrimitiveGenerator::generate(const std::string &type,
                                                     const std::unordered_map<std::string, std::any> &params) {
     static const std::unordered_map<
@@ -391,7 +542,10 @@ std::shared_ptr<Model> PrimitiveGenerator::generate(const std::string &type,
         generators = { { "cube", generate_cube },
                        { "sphere", generate_sphere },
                        { "plane", generate_plane },
-                       { "capsule", generate_capsule } };
+                       { "capsule", generate_capsule },
+                       { "convex_hull", generate_convex_hull },
+                       { "triangle_mesh", generate_triangle_mesh },
+                       { "height_field", generate_height_field } };
     if (auto it = generators.find(type); it != generators.end()) {
         return it->second(params);
     }
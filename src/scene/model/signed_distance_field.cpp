@@ -0,0 +1,305 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <core/fwd.h>
+#include <core/parallel/thread_pool.h>
+#include <fstream>
+#include <scene/model/model.h>
+#include <scene/model/signed_distance_field.h>
+#include <scene/model/triangle_mesh_bvh.h>
+
+namespace {
+constexpr uint32_t file_magic   = 0x46445353; // "SSDF"
+constexpr uint32_t file_version = 1;
+constexpr float band_cells      = 2.0f; // Narrow band width of from_model in cells
+
+// Slightly skewed axes, so parity rays do not run along the faces and edges of axis-aligned meshes
+const glm::vec3 parity_directions[3] = { glm::vec3(1.0f, 0.0013f, 0.0021f), glm::vec3(0.0017f, 1.0f, 0.0011f),
+                                         glm::vec3(0.0019f, 0.0023f, 1.0f) };
+
+uint64_t fnv1a_64(const void *data, size_t size, uint64_t hash = 14695981039346656037ull) {
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i)
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    return hash;
+}
+
+/**
+ * @brief Inside test by majority vote of three ray parities, robust against a ray grazing an edge
+ */
+bool is_inside(const TriangleMeshBVH &mesh, const glm::vec3 &point) {
+    int inside_votes = 0;
+    for (const auto &direction : parity_directions) {
+        int crossings = 0;
+        mesh.raycast(point, direction, FLT_MAX, [&](uint32_t triangle, float &) {
+            const auto corners = mesh.get_triangle(triangle);
+            float distance;
+            if (TriangleMeshBVH::intersect_triangle(point, direction, corners[0], corners[1], corners[2], distance))
+                ++crossings;
+        });
+        inside_votes += crossings & 1;
+    }
+    return inside_votes >= 2;
+}
+
+float signed_distance(const TriangleMeshBVH &mesh, const glm::vec3 &point) {
+    glm::vec3 closest;
+    uint32_t triangle;
+    if (!mesh.closest_point(point, FLT_MAX, closest, triangle))
+        return FLT_MAX;
+    const float distance = glm::length(point - closest);
+    return is_inside(mesh, point) ? -distance : distance;
+}
+
+/**
+ * @brief Position of a grid point given by its linear index, x fastest
+ */
+glm::vec3 grid_point(const glm::vec3 &origin, size_t index, size_t size_x, size_t size_y, float spacing) {
+    return origin + glm::vec3(static_cast<float>(index % size_x), static_cast<float>(index / size_x % size_y),
+                              static_cast<float>(index / size_x / size_y)) *
+                        spacing;
+}
+
+/**
+ * @brief Trilinear interpolation in a dense grid of samples with its analytic gradient in grid units
+ * @param size Number of samples along each axis, at least two
+ * @param position Position in grid units, clamped to the grid
+ */
+float trilinear(const float *grid, int size_x, int size_y, int size_z, const glm::vec3 &position,
+                glm::vec3 &gradient) {
+    const int size[3] = { size_x, size_y, size_z };
+    int base[3];
+    float t[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        base[axis] = std::min(std::max(static_cast<int>(std::floor(position[axis])), 0), size[axis] - 2);
+        t[axis]    = std::min(std::max(position[axis] - static_cast<float>(base[axis]), 0.0f), 1.0f);
+    }
+    auto at = [&](int dx, int dy, int dz) {
+        return grid[(base[0] + dx) + size_x * ((base[1] + dy) + size_y * (base[2] + dz))];
+    };
+    const float c000 = at(0, 0, 0), c100 = at(1, 0, 0), c010 = at(0, 1, 0), c110 = at(1, 1, 0);
+    const float c001 = at(0, 0, 1), c101 = at(1, 0, 1), c011 = at(0, 1, 1), c111 = at(1, 1, 1);
+    // Interpolate along x first, then y, then z
+    const float c00 = c000 + (c100 - c000) * t[0], c10 = c010 + (c110 - c010) * t[0];
+    const float c01 = c001 + (c101 - c001) * t[0], c11 = c011 + (c111 - c011) * t[0];
+    const float c0  = c00 + (c10 - c00) * t[1], c1 = c01 + (c11 - c01) * t[1];
+    const float dx0 = (c100 - c000) + ((c110 - c010) - (c100 - c000)) * t[1];
+    const float dx1 = (c101 - c001) + ((c111 - c011) - (c101 - c001)) * t[1];
+    gradient.x      = dx0 + (dx1 - dx0) * t[2];
+    gradient.y      = (c10 - c00) + ((c11 - c01) - (c10 - c00)) * t[2];
+    gradient.z      = c1 - c0;
+    return c0 + (c1 - c0) * t[2];
+}
+} // namespace
+
+std::shared_ptr<SignedDistanceField> SignedDistanceField::bake(const TriangleMeshBVH &mesh, float cell_size,
+                                                               float band) {
+    if (mesh.get_triangle_count() == 0 || cell_size <= 0.0f)
+        return nullptr;
+    auto field         = std::make_shared<SignedDistanceField>();
+    const auto &root   = mesh.get_nodes().front();
+    const float margin = band + cell_size;
+    const float edge   = cell_size * static_cast<float>(brick_size);
+
+    field->m_bounds_min = root.min;
+    field->m_bounds_max = root.max;
+    field->m_origin     = root.min - glm::vec3(margin);
+    field->m_cell_size  = cell_size;
+    for (int axis = 0; axis < 3; ++axis) {
+        const float extent        = root.max[axis] - root.min[axis] + 2.0f * margin;
+        field->m_brick_dims[axis] = std::max(static_cast<int>(std::ceil(extent / edge)), 1);
+    }
+    const glm::ivec3 dims     = field->m_brick_dims;
+    const size_t brick_count  = static_cast<size_t>(dims.x) * dims.y * dims.z;
+    const size_t corner_count = static_cast<size_t>(dims.x + 1) * (dims.y + 1) * (dims.z + 1);
+
+    // Coarse grid at the brick corners, and which bricks reach into the narrow band
+    field->m_coarse.resize(corner_count);
+    get_thread_pool()->parallel_for(corner_count, 16, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            field->m_coarse[i] = signed_distance(mesh, grid_point(field->m_origin, i, dims.x + 1, dims.y + 1, edge));
+        }
+    });
+    const float half_diagonal = 0.5f * edge * std::sqrt(3.0f);
+    std::vector<uint8_t> in_band(brick_count, 0);
+    get_thread_pool()->parallel_for(brick_count, 16, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const glm::vec3 center = grid_point(field->m_origin + glm::vec3(0.5f * edge), i, dims.x, dims.y, edge);
+            glm::vec3 closest;
+            uint32_t triangle;
+            in_band[i] = mesh.closest_point(center, half_diagonal + band, closest, triangle);
+        }
+    });
+    field->m_brick_slot.assign(brick_count, UINT32_MAX);
+    std::vector<uint32_t> stored;
+    for (size_t i = 0; i < brick_count; ++i) {
+        if (!in_band[i])
+            continue;
+        field->m_brick_slot[i] = static_cast<uint32_t>(stored.size() * brick_samples);
+        stored.push_back(static_cast<uint32_t>(i));
+    }
+
+    // Full resolution samples of the stored bricks, one brick per task
+    field->m_samples.resize(stored.size() * brick_samples);
+    get_thread_pool()->parallel_for(stored.size(), 1, [&](size_t, size_t begin, size_t end) {
+        constexpr int n = brick_size + 1;
+        for (size_t s = begin; s < end; ++s) {
+            const glm::vec3 brick_origin = grid_point(field->m_origin, stored[s], dims.x, dims.y, edge);
+            float *samples               = &field->m_samples[field->m_brick_slot[stored[s]]];
+            for (int z = 0; z < n; ++z) {
+                for (int y = 0; y < n; ++y) {
+                    for (int x = 0; x < n; ++x) {
+                        const glm::vec3 offset(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z));
+                        samples[x + n * (y + n * z)] = signed_distance(mesh, brick_origin + offset * cell_size);
+                    }
+                }
+            }
+        }
+    });
+    return field;
+}
+
+std::shared_ptr<SignedDistanceField> SignedDistanceField::from_model(const Model &model, int resolution) {
+    std::vector<glm::vec3> vertices;
+    std::vector<uint32_t> indices;
+    for (const auto &mesh : model.get_meshes()) {
+        const auto base = static_cast<uint32_t>(vertices.size());
+        for (const auto &vertex : mesh->get_vertices())
+            vertices.push_back(vertex.position);
+        for (const auto index : mesh->get_indices())
+            indices.push_back(base + index);
+    }
+    if (vertices.empty() || indices.empty() || resolution <= 0)
+        return nullptr;
+
+    // The cache key covers everything the bake depends on
+    uint64_t hash = fnv1a_64(vertices.data(), vertices.size() * sizeof(glm::vec3));
+    hash          = fnv1a_64(indices.data(), indices.size() * sizeof(uint32_t), hash);
+    hash          = fnv1a_64(&resolution, sizeof(resolution), hash);
+    hash          = fnv1a_64(&file_version, sizeof(file_version), hash);
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.sdf", static_cast<unsigned long long>(hash));
+    const auto cache_path = std::filesystem::path(M_PROJECT_SOURCE_DIR) / M_SDF_CACHE_DIR / name;
+    if (auto cached = load(cache_path, hash))
+        return cached;
+
+    const auto bvh = TriangleMeshBVH::build(std::move(vertices), std::move(indices));
+    if (!bvh)
+        return nullptr;
+    const auto &root       = bvh->get_nodes().front();
+    const glm::vec3 extent = root.max - root.min;
+    const float longest    = std::max(std::max(extent.x, extent.y), std::max(extent.z, FLT_EPSILON));
+    const float cell_size  = longest / static_cast<float>(resolution);
+
+    auto field = bake(*bvh, cell_size, band_cells * cell_size);
+    if (!field)
+        return nullptr;
+    field->m_hash = hash;
+    std::error_code ec;
+    std::filesystem::create_directories(cache_path.parent_path(), ec);
+    if (ec || !field->save(cache_path))
+        get_logger()->warn("[SignedDistanceField] Failed to write cache " + cache_path.string());
+    return field;
+}
+
+float SignedDistanceField::sample(const glm::vec3 &point, glm::vec3 &gradient) const noexcept {
+    // Clamp to the domain, the distance to the domain is added back afterwards
+    glm::vec3 cell, clamped;
+    int brick[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        cell[axis]    = (point[axis] - m_origin[axis]) / m_cell_size;
+        clamped[axis] = std::min(std::max(cell[axis], 0.0f), static_cast<float>(m_brick_dims[axis] * brick_size));
+        brick[axis]   = std::min(static_cast<int>(clamped[axis]) / brick_size, m_brick_dims[axis] - 1);
+    }
+    const uint32_t slot = m_brick_slot[brick[0] + m_brick_dims.x * (brick[1] + m_brick_dims.y * brick[2])];
+    float distance;
+    if (slot != UINT32_MAX) {
+        constexpr int n        = brick_size + 1;
+        const glm::vec3 offset = glm::vec3(static_cast<float>(brick[0]), static_cast<float>(brick[1]),
+                                           static_cast<float>(brick[2])) *
+                                 static_cast<float>(brick_size);
+        distance = trilinear(&m_samples[slot], n, n, n, clamped - offset, gradient);
+        gradient /= m_cell_size;
+    } else {
+        distance = trilinear(m_coarse.data(), m_brick_dims.x + 1, m_brick_dims.y + 1, m_brick_dims.z + 1,
+                             clamped / static_cast<float>(brick_size), gradient);
+        gradient /= m_cell_size * static_cast<float>(brick_size);
+    }
+    const glm::vec3 outside      = (cell - clamped) * m_cell_size;
+    const float outside_distance = glm::length(outside);
+    if (outside_distance > 0.0f) {
+        distance += outside_distance;
+        gradient = outside / outside_distance;
+    }
+    return distance;
+}
+
+bool SignedDistanceField::save(const std::filesystem::path &path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    const uint64_t coarse_count = m_coarse.size(), slot_count = m_brick_slot.size(), sample_count = m_samples.size();
+    file.write(reinterpret_cast<const char *>(&file_magic), sizeof(file_magic));
+    file.write(reinterpret_cast<const char *>(&file_version), sizeof(file_version));
+    file.write(reinterpret_cast<const char *>(&m_hash), sizeof(m_hash));
+    file.write(reinterpret_cast<const char *>(&m_origin), sizeof(m_origin));
+    file.write(reinterpret_cast<const char *>(&m_cell_size), sizeof(m_cell_size));
+    file.write(reinterpret_cast<const char *>(&m_brick_dims), sizeof(m_brick_dims));
+    file.write(reinterpret_cast<const char *>(&m_bounds_min), sizeof(m_bounds_min));
+    file.write(reinterpret_cast<const char *>(&m_bounds_max), sizeof(m_bounds_max));
+    file.write(reinterpret_cast<const char *>(&coarse_count), sizeof(coarse_count));
+    file.write(reinterpret_cast<const char *>(&slot_count), sizeof(slot_count));
+    file.write(reinterpret_cast<const char *>(&sample_count), sizeof(sample_count));
+    file.write(reinterpret_cast<const char *>(m_coarse.data()), static_cast<std::streamsize>(coarse_count * 4));
+    file.write(reinterpret_cast<const char *>(m_brick_slot.data()), static_cast<std::streamsize>(slot_count * 4));
+    file.write(reinterpret_cast<const char *>(m_samples.data()), static_cast<std::streamsize>(sample_count * 4));
+    return static_cast<bool>(file);
+}
+
+std::shared_ptr<SignedDistanceField> SignedDistanceField::load(const std::filesystem::path &path, uint64_t hash) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return nullptr;
+    uint32_t magic        = 0, version = 0;
+    uint64_t coarse_count = 0, slot_count = 0, sample_count = 0;
+    auto field            = std::make_shared<SignedDistanceField>();
+    file.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+    file.read(reinterpret_cast<char *>(&version), sizeof(version));
+    file.read(reinterpret_cast<char *>(&field->m_hash), sizeof(field->m_hash));
+    if (!file || magic != file_magic || version != file_version || field->m_hash != hash)
+        return nullptr;
+    file.read(reinterpret_cast<char *>(&field->m_origin), sizeof(field->m_origin));
+    file.read(reinterpret_cast<char *>(&field->m_cell_size), sizeof(field->m_cell_size));
+    file.read(reinterpret_cast<char *>(&field->m_brick_dims), sizeof(field->m_brick_dims));
+    file.read(reinterpret_cast<char *>(&field->m_bounds_min), sizeof(field->m_bounds_min));
+    file.read(reinterpret_cast<char *>(&field->m_bounds_max), sizeof(field->m_bounds_max));
+    file.read(reinterpret_cast<char *>(&coarse_count), sizeof(coarse_count));
+    file.read(reinterpret_cast<char *>(&slot_count), sizeof(slot_count));
+    file.read(reinterpret_cast<char *>(&sample_count), sizeof(sample_count));
+    const glm::ivec3 dims = field->m_brick_dims;
+    if (!file || dims.x <= 0 || dims.y <= 0 || dims.z <= 0 ||
+        slot_count != static_cast<uint64_t>(dims.x) * dims.y * dims.z ||
+        coarse_count != static_cast<uint64_t>(dims.x + 1) * (dims.y + 1) * (dims.z + 1) ||
+        sample_count % brick_samples != 0)
+        return nullptr;
+    field->m_coarse.resize(coarse_count);
+    field->m_brick_slot.resize(slot_count);
+    field->m_samples.resize(sample_count);
+    file.read(reinterpret_cast<char *>(field->m_coarse.data()), static_cast<std::streamsize>(coarse_count * 4));
+    file.read(reinterpret_cast<char *>(field->m_brick_slot.data()), static_cast<std::streamsize>(slot_count * 4));
+    file.read(reinterpret_cast<char *>(field->m_samples.data()), static_cast<std::streamsize>(sample_count * 4));
+    if (!file)
+        return nullptr;
+    for (const uint32_t slot : field->m_brick_slot) {
+        if (slot != UINT32_MAX && slot + brick_samples > sample_count)
+            return nullptr;
+    }
+    return field;
+}
+
+glm::vec3 SignedDistanceField::get_bounds_min() const noexcept { return m_bounds_min; }
+
+glm::vec3 SignedDistanceField::get_bounds_max() const noexcept { return m_bounds_max; }
+
+size_t SignedDistanceField::get_brick_count() const noexcept { return m_samples.size() / brick_samples; }
@@ -0,0 +1,310 @@
+#include <algorithm>
+#include <cfloat>
+#include <core/parallel/thread_pool.h>
+#include <scene/model/model.h>
+#include <scene/model/triangle_mesh_bvh.h>
+
+namespace {
+constexpr int bin_count           = 16;
+constexpr int parallel_depth      = 4; // Subtrees below this depth are built in parallel
+constexpr float traversal_cost    = 1.0f;
+constexpr float intersection_cost = 1.0f;
+
+struct Bounds {
+    glm::vec3 min{ FLT_MAX };
+    glm::vec3 max{ -FLT_MAX };
+
+    void grow(const glm::vec3 &point) {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    void grow(const Bounds &other) {
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    }
+
+    [[nodiscard]] float area() const {
+        if (min.x > max.x)
+            return 0.0f;
+        const glm::vec3 d = max - min;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+};
+
+/**
+ * @brief Shared input of a build: per-triangle bounds and the triangle order being partitioned
+ */
+struct BuildContext {
+    std::vector<Bounds> bounds;
+    std::vector<glm::vec3> centroids;
+    std::vector<uint32_t> order;
+};
+
+/**
+ * @brief Range of triangles left for a parallel subtree build, rooted at a placeholder node
+ */
+struct PendingSubtree {
+    uint32_t node;
+    uint32_t begin;
+    uint32_t end;
+};
+
+/**
+ * @brief Recursive binned SAH build of order[begin, end) into nodes[index]
+ * @param pending Ranges at parallel_depth are recorded here instead of being built, nullptr to build everything
+ */
+void build_node(BuildContext &context, std::vector<TriangleMeshBVH::Node> &nodes, uint32_t index, uint32_t begin,
+                uint32_t end, int depth, std::vector<PendingSubtree> *pending) {
+    Bounds bounds, centroid_bounds;
+    for (uint32_t i = begin; i < end; ++i) {
+        bounds.grow(context.bounds[context.order[i]]);
+        centroid_bounds.grow(context.centroids[context.order[i]]);
+    }
+    nodes[index]         = { bounds.min, begin, bounds.max, end - begin };
+    const uint32_t count = end - begin;
+    if (count <= TriangleMeshBVH::max_leaf_size || depth >= TriangleMeshBVH::max_depth)
+        return;
+    if (pending && depth == parallel_depth) {
+        pending->push_back({ index, begin, end });
+        return;
+    }
+
+    // Sweep the bins of every axis for the cheapest split plane
+    int best_axis           = -1;
+    int best_split          = 0;
+    float best_cost         = intersection_cost * static_cast<float>(count); // Cost of keeping a leaf
+    const float parent_area = bounds.area();
+    for (int axis = 0; axis < 3; ++axis) {
+        const float lower  = centroid_bounds.min[axis];
+        const float extent = centroid_bounds.max[axis] - lower;
+        if (extent <= FLT_EPSILON)
+            continue;
+        const float scale = static_cast<float>(bin_count) / extent;
+        Bounds bins[bin_count];
+        uint32_t bin_sizes[bin_count] = {};
+        for (uint32_t i = begin; i < end; ++i) {
+            const uint32_t t = context.order[i];
+            const int bin    = std::min(static_cast<int>((context.centroids[t][axis] - lower) * scale), bin_count - 1);
+            bins[bin].grow(context.bounds[t]);
+            ++bin_sizes[bin];
+        }
+        // Right-to-left prefix areas, then a left-to-right sweep
+        float right_area[bin_count];
+        uint32_t right_size[bin_count];
+        Bounds accumulated;
+        uint32_t size = 0;
+        for (int b = bin_count - 1; b > 0; --b) {
+            accumulated.grow(bins[b]);
+            size += bin_sizes[b];
+            right_area[b] = accumulated.area();
+            right_size[b] = size;
+        }
+        accumulated = Bounds{};
+        size        = 0;
+        for (int b = 0; b < bin_count - 1; ++b) {
+            accumulated.grow(bins[b]);
+            size += bin_sizes[b];
+            if (size == 0 || right_size[b + 1] == 0)
+                continue;
+            const float cost =
+                traversal_cost + intersection_cost *
+                                     (accumulated.area() * static_cast<float>(size) +
+                                      right_area[b + 1] * static_cast<float>(right_size[b + 1])) /
+                                     parent_area;
+            if (cost < best_cost) {
+                best_cost  = cost;
+                best_axis  = axis;
+                best_split = b + 1;
+            }
+        }
+    }
+    uint32_t middle = begin + count / 2;
+    if (best_axis >= 0) {
+        const float lower = centroid_bounds.min[best_axis];
+        const float scale = static_cast<float>(bin_count) / (centroid_bounds.max[best_axis] - lower);
+        const auto split  = std::partition(context.order.begin() + begin, context.order.begin() + end, [&](uint32_t t) {
+            return std::min(static_cast<int>((context.centroids[t][best_axis] - lower) * scale), bin_count - 1) <
+                   best_split;
+        });
+        middle = static_cast<uint32_t>(split - context.order.begin());
+    } else if (count <= TriangleMeshBVH::max_leaf_size * 4) {
+        return; // No split beats a leaf; only oversized leaves of coincident centroids get a median split
+    }
+
+    const auto left = static_cast<uint32_t>(nodes.size());
+    nodes.emplace_back();
+    nodes.emplace_back();
+    nodes[index].first = left;
+    nodes[index].count = 0;
+    build_node(context, nodes, left, begin, middle, depth + 1, pending);
+    build_node(context, nodes, left + 1, middle, end, depth + 1, pending);
+}
+} // namespace
+
+std::shared_ptr<TriangleMeshBVH> TriangleMeshBVH::build(std::vector<glm::vec3> vertices,
+                                                        std::vector<uint32_t> indices) {
+    const auto triangle_count = static_cast<uint32_t>(indices.size() / 3);
+    if (triangle_count == 0)
+        return nullptr;
+    BuildContext context;
+    context.bounds.resize(triangle_count);
+    context.centroids.resize(triangle_count);
+    context.order.resize(triangle_count);
+    get_thread_pool()->parallel_for(triangle_count, 1024, [&](size_t, size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            Bounds bounds;
+            for (int k = 0; k < 3; ++k)
+                bounds.grow(vertices[indices[t * 3 + k]]);
+            context.bounds[t]    = bounds;
+            context.centroids[t] = (bounds.min + bounds.max) * 0.5f;
+            context.order[t]     = static_cast<uint32_t>(t);
+        }
+    });
+
+    // Top levels serially, then every remaining subtree on its own thread into its own node array
+    auto bvh = std::make_shared<TriangleMeshBVH>();
+    bvh->m_nodes.reserve(triangle_count * 2 / max_leaf_size + 1);
+    bvh->m_nodes.emplace_back();
+    std::vector<PendingSubtree> pending;
+    build_node(context, bvh->m_nodes, 0, 0, triangle_count, 0, &pending);
+    std::vector<std::vector<Node>> subtrees(pending.size());
+    get_thread_pool()->parallel_for(pending.size(), 1, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            subtrees[i].emplace_back();
+            build_node(context, subtrees[i], 0, pending[i].begin, pending[i].end, parallel_depth, nullptr);
+        }
+    });
+    // Splice each subtree in place of its placeholder, in pending order so the layout is deterministic
+    for (size_t i = 0; i < pending.size(); ++i) {
+        const auto offset = static_cast<uint32_t>(bvh->m_nodes.size()) - 1; // Local node k > 0 lands at offset + k
+        auto &subtree     = subtrees[i];
+        for (auto &node : subtree) {
+            if (node.count == 0)
+                node.first += offset;
+        }
+        bvh->m_nodes[pending[i].node] = subtree.front();
+        bvh->m_nodes.insert(bvh->m_nodes.end(), subtree.begin() + 1, subtree.end());
+    }
+
+    bvh->m_indices.resize(indices.size());
+    for (uint32_t i = 0; i < triangle_count; ++i) {
+        for (int k = 0; k < 3; ++k)
+            bvh->m_indices[i * 3 + k] = indices[context.order[i] * 3 + k];
+    }
+    bvh->m_vertices = std::move(vertices);
+    return bvh;
+}
+
+std::shared_ptr<TriangleMeshBVH> TriangleMeshBVH::from_model(const Model &model) {
+    std::vector<glm::vec3> vertices;
+    std::vector<uint32_t> indices;
+    for (const auto &mesh : model.get_meshes()) {
+        const auto base = static_cast<uint32_t>(vertices.size());
+        for (const auto &vertex : mesh->get_vertices())
+            vertices.push_back(vertex.position);
+        for (const auto index : mesh->get_indices())
+            indices.push_back(base + index);
+    }
+    return build(std::move(vertices), std::move(indices));
+}
+
+bool TriangleMeshBVH::closest_point(const glm::vec3 &point, float max_distance, glm::vec3 &closest,
+                                    uint32_t &triangle) const {
+    // Squared distance from the query point to a node's box
+    auto box_distance = [&](const Node &node) {
+        const glm::vec3 d = glm::max(glm::max(node.min - point, point - node.max), glm::vec3(0.0f));
+        return glm::dot(d, d);
+    };
+    float best = max_distance * max_distance;
+    bool found = false;
+    uint32_t stack[max_depth + 2];
+    int size      = 0;
+    stack[size++] = 0;
+    while (size > 0) {
+        const Node &node = m_nodes[stack[--size]];
+        if (box_distance(node) >= best)
+            continue;
+        if (node.count > 0) {
+            for (uint32_t t = node.first; t < node.first + node.count; ++t) {
+                const auto corners      = get_triangle(t);
+                const glm::vec3 nearest = closest_point_on_triangle(point, corners[0], corners[1], corners[2]);
+                const float distance    = glm::dot(point - nearest, point - nearest);
+                if (distance < best) {
+                    best     = distance;
+                    closest  = nearest;
+                    triangle = t;
+                    found    = true;
+                }
+            }
+            continue;
+        }
+        // Nearer child on top of the stack, so the bound tightens quickly
+        const bool left_first = box_distance(m_nodes[node.first]) <= box_distance(m_nodes[node.first + 1]);
+        stack[size++]         = left_first ? node.first + 1 : node.first;
+        stack[size++]         = left_first ? node.first : node.first + 1;
+    }
+    return found;
+}
+
+glm::vec3 TriangleMeshBVH::closest_point_on_triangle(const glm::vec3 &point, const glm::vec3 &a, const glm::vec3 &b,
+                                                     const glm::vec3 &c) noexcept {
+    // Voronoi regions of the vertices, then the edges, then the face
+    const glm::vec3 ab = b - a, ac = c - a, ap = point - a;
+    const float d1     = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f)
+        return a;
+    const glm::vec3 bp = point - b;
+    const float d3     = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3)
+        return b;
+    const float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+        return a + ab * (d1 / (d1 - d3));
+    const glm::vec3 cp = point - c;
+    const float d5     = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6)
+        return c;
+    const float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+        return a + ac * (d2 / (d2 - d6));
+    const float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f)
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    const float denominator = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
+
+bool TriangleMeshBVH::intersect_triangle(const glm::vec3 &origin, const glm::vec3 &direction, const glm::vec3 &a,
+                                         const glm::vec3 &b, const glm::vec3 &c, float &distance) noexcept {
+    // Moller-Trumbore
+    const glm::vec3 ab = b - a, ac = c - a;
+    const glm::vec3 p  = glm::cross(direction, ac);
+    const float det    = glm::dot(ab, p);
+    if (std::abs(det) < 1e-12f)
+        return false;
+    const float inv_det = 1.0f / det;
+    const glm::vec3 s   = origin - a;
+    const float u       = glm::dot(s, p) * inv_det;
+    if (u < 0.0f || u > 1.0f)
+        return false;
+    const glm::vec3 q = glm::cross(s, ab);
+    const float v     = glm::dot(direction, q) * inv_det;
+    if (v < 0.0f || u + v > 1.0f)
+        return false;
+    distance = glm::dot(ac, q) * inv_det;
+    return distance > 0.0f;
+}
+
+std::array<glm::vec3, 3> TriangleMeshBVH::get_triangle(uint32_t triangle) const noexcept {
+    return { m_vertices[m_indices[triangle * 3]], m_vertices[m_indices[triangle * 3 + 1]],
+             m_vertices[m_indices[triangle * 3 + 2]] };
+}
+
+uint32_t TriangleMeshBVH::get_triangle_count() const noexcept { return static_cast<uint32_t>(m_indices.size() / 3); }
+
+const std::vector<TriangleMeshBVH::Node> &TriangleMeshBVH::get_nodes() const noexcept { return m_nodes; }
+
+const std::vector<glm::vec3> &TriangleMeshBVH::get_vertices() const noexcept { return m_vertices; }
+
+const std::vector<uint32_t> &TriangleMeshBVH::get_indices() const noexcept { return m_indices; }